@@ -14,11 +14,12 @@ uniform vec2 UVoffset = vec2(0, 0);
 // Setting this too high makes the clouds invisible
 const float CLOUD_DISSIPATION = 2.0;
 
-// Should be the same as its counterpart in CompoundCloudPlane.cs
+// Should be the same as its counterpart in Constants.cs
 const float CLOUD_MAX_INTENSITY_SHOWN = 1000f;
 
+// The densities texture contains the raw (not normalized) compound amounts
 float getIntensity(float value){
-    return min(0.8 * atan(0.003f * CLOUD_MAX_INTENSITY_SHOWN * value), 1.0f);
+    return min(0.8 * atan(0.003f * clamp(value, 0.0f, CLOUD_MAX_INTENSITY_SHOWN)), 1.0f);
 }
 
 void fragment(){
@@ -1,20 +1,20 @@
 shader_type spatial;
 
-// Set to 0 to disable wiggle
-uniform float wigglyNess = 1.f;
-
-uniform float movementWigglyNess = 1.f;
+// The material is shared by all membranes of a type. The per-membrane
+// values come from the mesh:
+// COLOR: tint
+// UV2.x: health fraction, UV2.y: dissolve value
+// TANGENT.x: wiggliness (0 disables the wiggle), TANGENT.y: movement wiggliness
 
 uniform sampler2D albedoTexture : hint_albedo;
 uniform sampler2D damagedTexture : hint_albedo;
 
 uniform sampler2D dissolveTexture : hint_albedo;
-uniform float dissolveValue : hint_range(0, 1);
-
-uniform float healthFraction = 0.5f;
-uniform vec4 tint : hint_color = vec4(1, 1, 1, 1);
 
 void vertex(){
+    float wigglyNess = TANGENT.x;
+    float movementWigglyNess = TANGENT.y;
+
     vec3 worldVertex = (WORLD_MATRIX * vec4(VERTEX, 1.0)).xyz;
     float size = length(VERTEX);
     
@@ -25,15 +25,18 @@ void vertex(){
 }
 
 void fragment(){
+    float healthFraction = UV2.x;
+    float dissolveValue = UV2.y;
+
     vec4 normal = texture(albedoTexture, UV);
     vec4 damaged = texture(damagedTexture, UV);
     vec4 final = ((normal * healthFraction) + 
-        (damaged * (1.f - healthFraction))) * tint;
+        (damaged * (1.f - healthFraction))) * COLOR;
 
     vec4 dissolveTex = texture(dissolveTexture, UV);
 
     float cutoff = dot(dissolveTex.rgb, vec3(0.3, 0.3, 0.3)) -
-        float(-0.8 + clamp(dissolveValue, 0, 1));
+        float(-0.8 + dissolveValue);
 
     ALBEDO = final.rgb;
     ALPHA = round(cutoff) * final.a;
@@ -0,0 +1,13 @@
+shader_type spatial;
+render_mode unshaded, cull_disabled;
+
+// Stands in for a microbe that is far from the camera, draws a disc in
+// the species colour on a quad
+// COLOR: species colour
+
+void fragment(){
+    if (length(UV - vec2(0.5)) > 0.5)
+        discard;
+
+    ALBEDO = COLOR.rgb;
+}
@@ -43,11 +43,46 @@ public static class Constants
 
     public const float CLOUD_DIFFUSION_RATE = 0.007f;
 
-    // Should be the same as its counterpart in shaders/CompoundCloudPlane.shader
+    // Should be the same as its counterpart in shaders/CompoundCloudPlane.shader, the shader clamps the raw
+    // densities to this before calculating the shown intensity
     public const float CLOUD_MAX_INTENSITY_SHOWN = 1000;
 
+    /// <summary>
+    ///   The cloud density textures are RGBA half-float, so 4 channels * 2 bytes
+    /// </summary>
+    public const int CLOUD_TEXTURE_BYTES_PER_PIXEL = 8;
+
     public const int MEMBRANE_RESOLUTION = 10;
 
+    /// <summary>
+    ///   Size of the broadphase grid cells of the planar physics. Should be a bit larger than most entities.
+    /// </summary>
+    public const float PLANAR_PHYSICS_GRID_CELL_SIZE = 16.0f;
+
+    /// <summary>
+    ///   The grid cells are hashed into this many buckets, so the grid doesn't need a fixed world size
+    /// </summary>
+    public const int PLANAR_PHYSICS_GRID_BUCKETS = 4096;
+
+    public const int PLANAR_PHYSICS_SOLVER_ITERATIONS = 4;
+
+    public const float PLANAR_PHYSICS_RESTITUTION = 0.1f;
+
+    /// <summary>
+    ///   Overlap that is allowed between bodies before their positions are corrected
+    /// </summary>
+    public const float PLANAR_PHYSICS_PENETRATION_SLOP = 0.01f;
+
+    /// <summary>
+    ///   Fraction of the overlap that is corrected each step
+    /// </summary>
+    public const float PLANAR_PHYSICS_POSITION_CORRECTION = 0.8f;
+
+    /// <summary>
+    ///   Used for bodies that use the project default damping. Same as the Godot default.
+    /// </summary>
+    public const float PLANAR_PHYSICS_DEFAULT_LINEAR_DAMP = 0.1f;
+
     /// <summary>
     ///   BASE MOVEMENT ATP cost. Cancels out a little bit more then one cytoplasm's glycolysis
     /// </summary>
@@ -88,6 +123,206 @@ public static class Constants
 
     public const int MICROBE_AI_OBJECTS_PER_TASK = 15;
 
+    /// <summary>
+    ///   Fraction of the frame time the quality governor allows the CPU side to take, the rest is left for
+    ///   rendering
+    /// </summary>
+    public const float QUALITY_GOVERNOR_CPU_BUDGET_FRACTION = 0.75f;
+
+    /// <summary>
+    ///   Weight of new frame cost samples in the governor moving averages
+    /// </summary>
+    public const float QUALITY_GOVERNOR_SMOOTHING = 0.05f;
+
+    /// <summary>
+    ///   How much over the budget the frame cost needs to be before the governor starts degrading quality
+    /// </summary>
+    public const float QUALITY_GOVERNOR_DEGRADE_MARGIN = 0.1f;
+
+    /// <summary>
+    ///   How much under the budget the frame cost needs to be before the governor starts improving quality.
+    ///   This is larger than the degrade margin so that a single step doesn't flip back and forth.
+    /// </summary>
+    public const float QUALITY_GOVERNOR_IMPROVE_MARGIN = 0.3f;
+
+    /// <summary>
+    ///   Seconds the frame cost must stay over the budget for quality to be degraded by one step
+    /// </summary>
+    public const float QUALITY_GOVERNOR_DEGRADE_DELAY = 2.0f;
+
+    /// <summary>
+    ///   Seconds the frame cost must stay under the budget for quality to be improved by one step
+    /// </summary>
+    public const float QUALITY_GOVERNOR_IMPROVE_DELAY = 10.0f;
+
+    public const float QUALITY_GOVERNOR_CLOUD_INTERVAL_STEP = 0.04f;
+    public const int QUALITY_GOVERNOR_MAX_CLOUD_INTERVAL_LEVEL = 4;
+
+    public const int QUALITY_GOVERNOR_MAX_CLOUD_RESOLUTION = 4;
+    public const int QUALITY_GOVERNOR_MAX_CLOUD_RESOLUTION_LEVEL = 2;
+
+    public const float QUALITY_GOVERNOR_ENTITY_STEP = 0.15f;
+    public const float QUALITY_GOVERNOR_MIN_ENTITY_FRACTION = 0.4f;
+    public const int QUALITY_GOVERNOR_MAX_ENTITY_LEVEL = 4;
+
+    /// <summary>
+    ///   How long in milliseconds a parallel task of the stage systems should ideally take
+    /// </summary>
+    public const float TARGET_TASK_DURATION = 0.5f;
+
+    /// <summary>
+    ///   Tasks are not split smaller than this (in milliseconds) to spread work over more threads, as then the
+    ///   task overhead starts to dominate
+    /// </summary>
+    public const float MIN_TASK_DURATION = 0.05f;
+
+    /// <summary>
+    ///   Weight of new measurements in the per object cost used for the task sizes
+    /// </summary>
+    public const float TASK_SIZE_COST_SMOOTHING = 0.1f;
+
+    /// <summary>
+    ///   Seconds between the memory use updates in the FPS overlay
+    /// </summary>
+    public const float MEMORY_REPORT_INTERVAL = 1.0f;
+
+    /// <summary>
+    ///   Seconds between writing the metrics file
+    /// </summary>
+    public const float METRICS_EXPORT_INTERVAL = 10.0f;
+
+    /// <summary>
+    ///   How many frames after entering a stage or the editor are timed, to see the JIT warm-up effect
+    /// </summary>
+    public const int FIRST_FRAMES_MEASURED = 120;
+
+    /// <summary>
+    ///   Width of a cell in the coarse compound gradient field the AI uses to find compounds
+    /// </summary>
+    public const int COMPOUND_GRADIENT_CELL_SIZE = 30;
+
+    /// <summary>
+    ///   Points sampled from the clouds per side of a gradient field cell
+    /// </summary>
+    public const int COMPOUND_GRADIENT_SAMPLES = 3;
+
+    /// <summary>
+    ///   Seconds between the compound gradient field updates
+    /// </summary>
+    public const float COMPOUND_GRADIENT_UPDATE_INTERVAL = 0.5f;
+
+    /// <summary>
+    ///   Gradient length under which the AI ignores the compound gradient field
+    /// </summary>
+    public const float AI_COMPOUND_GRADIENT_MIN_STRENGTH = 0.5f;
+
+    /// <summary>
+    ///   Default for the bytes the compressed snapshots of the patches the player has left may take in total, the
+    ///   cap is stored in PatchSnapshotCache.MemoryCap so it can be changed per world
+    /// </summary>
+    public const long PATCH_SNAPSHOT_MEMORY_CAP = 32 * 1024 * 1024;
+
+    /// <summary>
+    ///   Seconds the compound spawners wait after the clouds of a patch are restored from a snapshot
+    /// </summary>
+    public const float PATCH_SNAPSHOT_CLOUD_SPAWN_DELAY = 30.0f;
+
+    /// <summary>
+    ///   Entities closer than this to the player get the full simulation
+    /// </summary>
+    public const float SIMULATION_TIER_NEAR_DISTANCE = 70.0f;
+
+    /// <summary>
+    ///   Entities further than this from the player get the coarse simulation
+    /// </summary>
+    public const float SIMULATION_TIER_FAR_DISTANCE = 130.0f;
+
+    /// <summary>
+    ///   Seconds between sorting the entities into the simulation tiers
+    /// </summary>
+    public const float SIMULATION_TIER_UPDATE_INTERVAL = 0.25f;
+
+    /// <summary>
+    ///   Seconds between the process runs of mid range entities
+    /// </summary>
+    public const float SIMULATION_TIER_MID_PROCESS_INTERVAL = 0.1f;
+
+    /// <summary>
+    ///   Seconds between the process runs and the batched updates of far entities
+    /// </summary>
+    public const float SIMULATION_TIER_FAR_UPDATE_INTERVAL = 0.5f;
+
+    /// <summary>
+    ///   Seconds between the AI runs of far entities, near and mid range ones use MICROBE_AI_THINK_INTERVAL
+    /// </summary>
+    public const float SIMULATION_TIER_FAR_AI_THINK_INTERVAL = 1.5f;
+
+    /// <summary>
+    ///   Microbes closer than this to the camera are drawn with full detail. With the 90 degree field of view the
+    ///   screen corners are about 2.5 times the camera height away on a 21:9 screen, so this covers the whole
+    ///   screen at the default camera height of 40.
+    /// </summary>
+    public const float MICROBE_FULL_DETAIL_DISTANCE = 100.0f;
+
+    /// <summary>
+    ///   Microbes closer than this to the camera (and not in full detail) are drawn with a simpler membrane and
+    ///   without organelles, further ones are drawn as impostors
+    /// </summary>
+    public const float MICROBE_REDUCED_DETAIL_DISTANCE = 160.0f;
+
+    /// <summary>
+    ///   Seconds between checking which visual detail level each microbe should use
+    /// </summary>
+    public const float MICROBE_VISUAL_DETAIL_UPDATE_INTERVAL = 0.2f;
+
+    /// <summary>
+    ///   Only every this many points of the membrane outline are used for the mesh in reduced detail
+    /// </summary>
+    public const int MEMBRANE_REDUCED_DETAIL_VERTEX_STEP = 3;
+
+    /// <summary>
+    ///   Total compound amount above which a cloud cell is counted as active in the metrics
+    /// </summary>
+    public const float CLOUD_ACTIVE_CELL_THRESHOLD = 0.01f;
+
+    /// <summary>
+    ///   Seconds between the soak test samples
+    /// </summary>
+    public const float SOAK_SAMPLE_INTERVAL = 30.0f;
+
+    /// <summary>
+    ///   Seconds the soak test spends in the stage before going to the editor
+    /// </summary>
+    public const float SOAK_EDITOR_INTERVAL = 180.0f;
+
+    /// <summary>
+    ///   Soak test samples ignored for leak detection while the game warms up
+    /// </summary>
+    public const int SOAK_WARMUP_SAMPLES = 4;
+
+    public const int SOAK_MIN_TREND_SAMPLES = 8;
+
+    /// <summary>
+    ///   How much a metric needs to grow over the soak test to be reported
+    /// </summary>
+    public const float SOAK_GROWTH_THRESHOLD = 0.2f;
+
+    /// <summary>
+    ///   A memory metric also needs to grow at least this many bytes to be reported, so that metrics starting
+    ///   from 0 aren't reported for any small growth
+    /// </summary>
+    public const double SOAK_MIN_GROWTH_BYTES = 4 * 1024 * 1024;
+
+    /// <summary>
+    ///   Same as SOAK_MIN_GROWTH_BYTES but for object counts
+    /// </summary>
+    public const double SOAK_MIN_GROWTH_COUNT = 100;
+
+    /// <summary>
+    ///   Fraction of the samples that need to not decrease for a metric to count as growing
+    /// </summary>
+    public const float SOAK_MONOTONIC_FRACTION = 0.9f;
+
     public const int INITIAL_SPECIES_POPULATION = 100;
 
     public const int INITIAL_FREEBUILD_POPULATION_VARIANCE_MIN = 0;
@@ -107,6 +342,11 @@ public static class Constants
     /// </summary>
     public const float AGENT_EMISSION_IMPULSE_STRENGTH = 20.0f;
 
+    /// <summary>
+    ///   Collision radius of agent projectiles in the planar physics. Matches the shape in AgentProjectile.tscn
+    /// </summary>
+    public const float AGENT_PROJECTILE_RADIUS = 1.42f;
+
     public const float OXYTOXY_DAMAGE = 10.0f;
 
     public const float AGENT_EMISSION_DISTANCE_OFFSET = 0.5f;
@@ -348,6 +588,9 @@ public static class Constants
     // Cooldown for AI for toggling engulfing
     public const float AI_ENGULF_INTERVAL = 300;
 
+    // Predators that can shoot toxins are fled from this many times further away
+    public const float AI_TOXIC_PREDATOR_FLEE_MULTIPLIER = 1.5f;
+
     // if you are gaining less then this amount of compound per turn you are much more likely to turn randomly
     public const float AI_COMPOUND_BIAS = -10.0f;
 
@@ -368,6 +611,33 @@ public static class Constants
     /// </summary>
     public const int AUTO_EVO_VARIANT_SIMULATION_STEPS = 10;
 
+    /// <summary>
+    ///   Population simulation steps (of the whole map) that one auto-evo run can use for trying variants
+    /// </summary>
+    public const int AUTO_EVO_SIMULATION_BUDGET = 4000;
+
+    /// <summary>
+    ///   Part of the budget of a species used for mutations, the rest is for migrations
+    /// </summary>
+    public const float AUTO_EVO_MUTATION_BUDGET_FRACTION = 0.6f;
+
+    /// <summary>
+    ///   Most candidates compared by one mutation or migration step
+    /// </summary>
+    public const int AUTO_EVO_MAX_VARIANT_CANDIDATES = 16;
+
+    /// <summary>
+    ///   A variant whose score is this many times the second best wins without simulating the rest of the rounds
+    /// </summary>
+    public const float AUTO_EVO_CLEAR_WIN_SCORE_RATIO = 1.5f;
+
+    /// <summary>
+    ///   When the best two variants are within this fraction of each other more variants are tried
+    /// </summary>
+    public const float AUTO_EVO_CLOSE_SCORE_FRACTION = 0.05f;
+
+    public const int AUTO_EVO_EXTRA_CANDIDATES_FOR_CLOSE_SCORES = 2;
+
     /// <summary>
     ///   Populations of species that are under this will be killed off by auto-evo
     /// </summary>
@@ -386,6 +656,21 @@ public static class Constants
     public const float AUTO_EVO_SUNLIGHT_ENERGY_AMOUNT = 6000;
     public const float AUTO_EVO_COMPOUND_ENERGY_AMOUNT = 600;
 
+    /// <summary>
+    ///   The genome intern table is emptied when it reaches this size, auto-evo creates lots of short lived designs
+    /// </summary>
+    public const int GENOME_INTERN_TABLE_MAX_SIZE = 4096;
+
+    /// <summary>
+    ///   How many of the latest generations the population history keeps
+    /// </summary>
+    public const int POPULATION_HISTORY_GENERATIONS = 128;
+
+    /// <summary>
+    ///   How many unused collections of each type a CollectionArena keeps for the next frame or step
+    /// </summary>
+    public const int COLLECTION_ARENA_MAX_FREE_PER_TYPE = 64;
+
     public const float GLUCOSE_REDUCTION_RATE = 0.8f;
 
     public const int MAX_SPAWNS_PER_FRAME = 2;
@@ -435,6 +720,11 @@ public static class Constants
     /// </summary>
     public const string FLUID_EFFECT_GROUP = "fluid_effect";
 
+    /// <summary>
+    ///   All RigidBody nodes tagged with this are simulated by the planar physics system when it is enabled
+    /// </summary>
+    public const string PLANAR_PHYSICS_GROUP = "planar_physics";
+
     /// <summary>
     ///   All Nodes tagged with this are handled by the process system
     /// </summary>
@@ -464,6 +754,8 @@ public static class Constants
 
     public const string SCREENSHOT_FOLDER = "user://screenshots";
 
+    public const string BENCHMARK_FOLDER = "user://benchmarks";
+
     public const string LOGS_FOLDER_NAME = "logs";
 
     /// <summary>
@@ -0,0 +1,210 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading.Tasks;
+using Godot;
+
+/// <summary>
+///   Runs a number of auto-evo generations back to back in a background thread. Each generation does an auto-evo
+///   run, passes the world time and applies the results like entering the editor does.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The world may not be used by anything else while this is running. A generation is applied only after its
+///     run has finished, so after aborting the world is left at the end of the last completed generation.
+///   </para>
+/// </remarks>
+public class AutoEvoFastForward
+{
+    private readonly GameWorld world;
+    private readonly bool playerCantGoExtinct;
+
+    private readonly List<Checkpoint> checkpoints = new List<Checkpoint>();
+
+    private readonly Stopwatch stopwatch = new Stopwatch();
+
+    private volatile AutoEvoRun currentRun;
+
+    private bool started;
+    private volatile bool running;
+    private volatile bool finished;
+    private volatile bool aborted;
+
+    public AutoEvoFastForward(GameWorld world, int generations, bool playerCantGoExtinct)
+    {
+        if (generations < 1)
+            throw new ArgumentException("need to run at least one generation", nameof(generations));
+
+        this.world = world;
+        this.playerCantGoExtinct = playerCantGoExtinct;
+        Generations = generations;
+    }
+
+    public int Generations { get; }
+
+    public bool Running { get => running; private set => running = value; }
+
+    public bool Finished { get => finished; private set => finished = value; }
+
+    public bool Aborted { get => aborted; private set => aborted = value; }
+
+    public int CompletedGenerations
+    {
+        get
+        {
+            lock (checkpoints)
+                return checkpoints.Count;
+        }
+    }
+
+    public double GenerationsPerSecond
+    {
+        get
+        {
+            var seconds = stopwatch.Elapsed.TotalSeconds;
+
+            if (seconds <= 0)
+                return 0;
+
+            return CompletedGenerations / seconds;
+        }
+    }
+
+    public string Status
+    {
+        get
+        {
+            if (Aborted)
+                return "Aborted.";
+
+            if (Finished)
+                return $"Finished {CompletedGenerations:n0} generations.";
+
+            if (!Running)
+                return "Not running.";
+
+            var run = currentRun;
+
+            return $"Generation {CompletedGenerations + 1:n0}/{Generations:n0}, " +
+                $"{GenerationsPerSecond:F2} generations per second. {run?.Status}";
+        }
+    }
+
+    /// <summary>
+    ///   Returns a copy of the checkpoints, there is one for each completed generation
+    /// </summary>
+    public List<Checkpoint> GetCheckpoints()
+    {
+        lock (checkpoints)
+            return checkpoints.ToList();
+    }
+
+    public void Start()
+    {
+        if (started)
+            return;
+
+        TaskExecutor.Instance.AddTask(new Task(Run));
+        started = true;
+    }
+
+    /// <summary>
+    ///   Runs the generations in the calling thread instead of starting a background task, returns once finished
+    /// </summary>
+    public void RunInCurrentThread()
+    {
+        if (started)
+            throw new InvalidOperationException("This fast forward has already been started");
+
+        started = true;
+        Run();
+    }
+
+    /// <summary>
+    ///   Stops after the current generation, which isn't applied
+    /// </summary>
+    public void Abort()
+    {
+        Aborted = true;
+        currentRun?.Abort();
+    }
+
+    private void Run()
+    {
+        Running = true;
+        stopwatch.Start();
+
+        try
+        {
+            while (!Aborted && CompletedGenerations < Generations)
+            {
+                var run = new AutoEvoRun(world);
+                currentRun = run;
+
+                // The run is executed in this thread as the fast forward already is a background task
+                run.RunInCurrentThread();
+
+                if (!run.WasSuccessful)
+                {
+                    if (!Aborted)
+                        GD.PrintErr("Auto-evo fast forward stopped because a run failed: ", run.Status);
+
+                    Aborted = true;
+                    break;
+                }
+
+                world.OnTimePassed(1);
+                world.ApplyAutoEvoResults(run, playerCantGoExtinct);
+
+                var checkpoint = CreateCheckpoint();
+
+                lock (checkpoints)
+                    checkpoints.Add(checkpoint);
+            }
+        }
+        catch (Exception e)
+        {
+            Aborted = true;
+            GD.PrintErr("Auto-evo fast forward failed with an exception: ", e);
+        }
+
+        stopwatch.Stop();
+        currentRun = null;
+
+        Running = false;
+        Finished = true;
+    }
+
+    private Checkpoint CreateCheckpoint()
+    {
+        var species = world.Map.FindAllSpeciesWithPopulation();
+
+        return new Checkpoint
+        {
+            Generation = CompletedGenerations + 1,
+            TotalPassedTime = world.TotalPassedTime,
+            Seconds = stopwatch.Elapsed.TotalSeconds,
+            SpeciesPopulations = species.ToDictionary(item => item.ID, item => item.Population),
+        };
+    }
+
+    /// <summary>
+    ///   The state of the world after a generation
+    /// </summary>
+    public class Checkpoint
+    {
+        public int Generation { get; set; }
+        public double TotalPassedTime { get; set; }
+
+        /// <summary>
+        ///   Time since the fast forward started
+        /// </summary>
+        public double Seconds { get; set; }
+
+        /// <summary>
+        ///   Global populations of the living species by species ID
+        /// </summary>
+        public Dictionary<uint, long> SpeciesPopulations { get; set; }
+    }
+}
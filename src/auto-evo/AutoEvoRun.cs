@@ -15,9 +15,7 @@ public class AutoEvoRun
 {
     // Configuration parameters for auto evo
     // TODO: allow loading these from JSON
-    private const int MUTATIONS_PER_SPECIES = 3;
     private const bool ALLOW_NO_MUTATION = true;
-    private const int MOVE_ATTEMPTS_PER_SPECIES = 5;
     private const bool ALLOW_NO_MIGRATION = true;
 
     private readonly RunParameters parameters;
@@ -99,7 +97,8 @@ public class AutoEvoRun
             if (total <= 0)
                 return 0;
 
-            return (float)CompleteSteps / total;
+            // Steps that try extra variants can run a bit over the initial estimate
+            return Math.Min(1.0f, (float)CompleteSteps / total);
         }
     }
 
@@ -168,6 +167,18 @@ public class AutoEvoRun
         started = true;
     }
 
+    /// <summary>
+    ///   Runs this in the calling thread instead of starting a background task, returns once finished
+    /// </summary>
+    public void RunInCurrentThread()
+    {
+        if (started)
+            throw new InvalidOperationException("This run has already been started");
+
+        started = true;
+        Run();
+    }
+
     public void Abort()
     {
         Aborted = true;
@@ -357,6 +368,7 @@ public class AutoEvoRun
     private void GatherInfo()
     {
         var alreadyHandledSpecies = new HashSet<Species>();
+        var evolvingSpecies = new List<Species>();
 
         var map = parameters.World.Map;
 
@@ -371,19 +383,27 @@ public class AutoEvoRun
 
                 // The player species doesn't get random mutations. And also doesn't
                 // spread automatically
-                if (speciesEntry.Key.PlayerSpecies)
-                {
-                }
-                else
-                {
-                    runSteps.Enqueue(new FindBestMutation(map, speciesEntry.Key, MUTATIONS_PER_SPECIES,
-                        ALLOW_NO_MUTATION));
-                    runSteps.Enqueue(new FindBestMigration(map, speciesEntry.Key, MOVE_ATTEMPTS_PER_SPECIES,
-                        ALLOW_NO_MIGRATION));
-                }
+                if (!speciesEntry.Key.PlayerSpecies)
+                    evolvingSpecies.Add(speciesEntry.Key);
             }
         }
 
+        var budget = new SimulationBudget(Constants.AUTO_EVO_SIMULATION_BUDGET, evolvingSpecies);
+
+        // Each step gets its own Random so that the results only depend on the world seed
+        var random = parameters.World.CreateRandom();
+
+        foreach (var species in evolvingSpecies)
+        {
+            var allocation = budget.GetAllocation(species);
+            var mutationAllocation = (int)(allocation * Constants.AUTO_EVO_MUTATION_BUDGET_FRACTION);
+
+            runSteps.Enqueue(new FindBestMutation(map, species, new Random(random.Next()), budget,
+                mutationAllocation, ALLOW_NO_MUTATION));
+            runSteps.Enqueue(new FindBestMigration(map, species, new Random(random.Next()), budget,
+                allocation - mutationAllocation, ALLOW_NO_MIGRATION));
+        }
+
         // The new populations don't depend on the mutations, this is so that when
         // the player edits their species the other species they are competing
         // against are the same (so we can show some performance predictions in the
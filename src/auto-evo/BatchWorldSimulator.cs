@@ -0,0 +1,235 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Godot;
+
+/// <summary>
+///   Simulates many independent freebuild worlds in parallel, each running a number of auto-evo generations. Used
+///   for balancing experiments that need results from lots of worlds.
+/// </summary>
+/// <remarks>
+///   <para>
+///     Each world is created from its own seed and is simulated in a single task with AutoEvoFastForward, the
+///     worlds share only the read only simulation parameters. So the summary of a seed is the same no matter how
+///     many worlds run at once and the throughput grows with the number of TaskExecutor threads.
+///   </para>
+/// </remarks>
+public class BatchWorldSimulator
+{
+    private readonly List<int> seeds;
+
+    /// <summary>
+    ///   Summaries in the same order as the seeds, null until the world is done
+    /// </summary>
+    private readonly WorldSummary[] summaries;
+
+    /// <summary>
+    ///   The fast forwards of the worlds currently being simulated, so that they can be aborted
+    /// </summary>
+    private readonly List<AutoEvoFastForward> runningFastForwards = new List<AutoEvoFastForward>();
+
+    private readonly Stopwatch stopwatch = new Stopwatch();
+
+    private bool started;
+    private int finishedWorlds;
+    private volatile bool aborted;
+
+    public BatchWorldSimulator(IEnumerable<int> seeds, int generations)
+    {
+        if (generations < 1)
+            throw new ArgumentException("need to run at least one generation", nameof(generations));
+
+        this.seeds = seeds.ToList();
+        Generations = generations;
+
+        summaries = new WorldSummary[this.seeds.Count];
+    }
+
+    public int Generations { get; }
+
+    public int WorldCount => seeds.Count;
+
+    public int FinishedWorlds => Volatile.Read(ref finishedWorlds);
+
+    public bool Finished => started && FinishedWorlds >= WorldCount;
+
+    public bool Aborted => aborted;
+
+    public double Seconds => stopwatch.Elapsed.TotalSeconds;
+
+    public double WorldsPerSecond
+    {
+        get
+        {
+            var seconds = Seconds;
+
+            if (seconds <= 0)
+                return 0;
+
+            return FinishedWorlds / seconds;
+        }
+    }
+
+    public string Status => $"{FinishedWorlds:n0}/{WorldCount:n0} worlds done, " +
+        $"{WorldsPerSecond:F2} worlds per second using {TaskExecutor.Instance.ParallelTasks} threads";
+
+    /// <summary>
+    ///   Returns the summaries of the finished worlds in seed order
+    /// </summary>
+    public List<WorldSummary> GetSummaries()
+    {
+        lock (summaries)
+            return summaries.Where(summary => summary != null).ToList();
+    }
+
+    /// <summary>
+    ///   Queues a task for each world
+    /// </summary>
+    public void Start()
+    {
+        if (started)
+            return;
+
+        started = true;
+        stopwatch.Start();
+
+        if (WorldCount < 1)
+        {
+            stopwatch.Stop();
+            return;
+        }
+
+        for (int i = 0; i < seeds.Count; ++i)
+        {
+            int index = i;
+            TaskExecutor.Instance.AddTask(new Task(() => SimulateWorld(index)));
+        }
+    }
+
+    /// <summary>
+    ///   Makes the worlds that haven't started yet finish right away, the running ones stop after their current
+    ///   generation
+    /// </summary>
+    public void Abort()
+    {
+        aborted = true;
+
+        lock (runningFastForwards)
+        {
+            foreach (var fastForward in runningFastForwards)
+                fastForward.Abort();
+        }
+    }
+
+    private void SimulateWorld(int index)
+    {
+        var summary = new WorldSummary { Seed = seeds[index] };
+
+        try
+        {
+            if (!aborted)
+                Simulate(summary);
+        }
+        catch (Exception e)
+        {
+            summary.Error = e.Message;
+            GD.PrintErr("Batch world simulation with seed ", summary.Seed, " failed: ", e);
+        }
+
+        lock (summaries)
+            summaries[index] = summary;
+
+        if (Interlocked.Increment(ref finishedWorlds) >= WorldCount)
+            stopwatch.Stop();
+    }
+
+    private void Simulate(WorldSummary summary)
+    {
+        var timer = Stopwatch.StartNew();
+
+        var world = new GameWorld(new WorldGenerationSettings { Seed = summary.Seed });
+        world.GenerateRandomSpeciesForFreeBuild();
+
+        var initialSpecies = world.Map.FindAllSpeciesWithPopulation().Count;
+
+        // The world is only used by this task so the fast forward can run here instead of in a task of its own.
+        // Like in freebuild the player species is allowed to go extinct.
+        var fastForward = new AutoEvoFastForward(world, Generations, true);
+
+        lock (runningFastForwards)
+        {
+            // Checked again here as an abort may have happened while the world was created
+            if (aborted)
+                fastForward.Abort();
+
+            runningFastForwards.Add(fastForward);
+        }
+
+        try
+        {
+            fastForward.RunInCurrentThread();
+        }
+        finally
+        {
+            lock (runningFastForwards)
+                runningFastForwards.Remove(fastForward);
+        }
+
+        var species = world.Map.FindAllSpeciesWithPopulation();
+
+        summary.CompletedGenerations = fastForward.CompletedGenerations;
+        summary.Seconds = timer.Elapsed.TotalSeconds;
+        summary.TotalPassedTime = world.TotalPassedTime;
+        summary.InitialSpecies = initialSpecies;
+        summary.TotalPopulation = species.Sum(item => item.Population);
+        summary.Species = species.Select(item => new SpeciesSummary
+        {
+            ID = item.ID,
+            Name = item.FormattedName,
+            Population = item.Population,
+            Organelles = (item as MicrobeSpecies)?.Organelles.Count ?? 0,
+        }).OrderByDescending(item => item.Population).ToList();
+
+        if (fastForward.Aborted && summary.Error == null)
+            summary.Error = aborted ? "Aborted" : "Auto-evo run failed";
+    }
+
+    /// <summary>
+    ///   The end state of one simulated world
+    /// </summary>
+    public class WorldSummary
+    {
+        public int Seed { get; set; }
+        public int CompletedGenerations { get; set; }
+
+        /// <summary>
+        ///   Time it took to create and simulate the world
+        /// </summary>
+        public double Seconds { get; set; }
+
+        public double TotalPassedTime { get; set; }
+        public int InitialSpecies { get; set; }
+        public long TotalPopulation { get; set; }
+
+        /// <summary>
+        ///   The living species, most populous first
+        /// </summary>
+        public List<SpeciesSummary> Species { get; set; } = new List<SpeciesSummary>();
+
+        /// <summary>
+        ///   Why the world didn't complete all the generations, null if it did
+        /// </summary>
+        public string Error { get; set; }
+    }
+
+    public class SpeciesSummary
+    {
+        public uint ID { get; set; }
+        public string Name { get; set; }
+        public long Population { get; set; }
+        public int Organelles { get; set; }
+    }
+}
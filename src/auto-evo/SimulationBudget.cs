@@ -0,0 +1,66 @@
+namespace AutoEvo
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Linq;
+
+    /// <summary>
+    ///   Splits the population simulation steps an auto-evo run may use between the species. The unit is one
+    ///   simulation step of the whole map, so the total run time stays about the same no matter how many species
+    ///   there are.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     Species with bigger populations get a bigger share, it grows with the square root of the population so
+    ///     that small species still get to try some variants. Steps that finish early give their unused steps to a
+    ///     shared pool, which the later steps can take from when their best variants are too close to call.
+    ///   </para>
+    /// </remarks>
+    public class SimulationBudget
+    {
+        private readonly Dictionary<Species, int> allocations = new Dictionary<Species, int>();
+
+        public SimulationBudget(int total, ICollection<Species> species)
+        {
+            Total = total;
+
+            var weights = species.ToDictionary(item => item, item => Math.Sqrt(Math.Max(item.Population, 1)));
+            var totalWeight = weights.Values.Sum();
+
+            foreach (var entry in weights)
+                allocations[entry.Key] = (int)(total * entry.Value / totalWeight);
+        }
+
+        public int Total { get; }
+
+        /// <summary>
+        ///   Steps given back by the steps that didn't need all of their share
+        /// </summary>
+        public int Unused { get; private set; }
+
+        public int GetAllocation(Species species)
+        {
+            allocations.TryGetValue(species, out var allocation);
+            return allocation;
+        }
+
+        public void ReturnUnused(int steps)
+        {
+            if (steps > 0)
+                Unused += steps;
+        }
+
+        /// <summary>
+        ///   Takes steps from the unused pool if there are enough
+        /// </summary>
+        /// <returns>True if the steps were taken</returns>
+        public bool TryTakeUnused(int steps)
+        {
+            if (steps > Unused)
+                return false;
+
+            Unused -= steps;
+            return true;
+        }
+    }
+}
@@ -8,6 +8,13 @@
     ///   Main class for the population simulation part.
     ///   This contains the algorithm for determining how much population species gain or lose
     /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     The steps are ran by PopulationSimulationCore on flat arrays. SimulateReference is the original
+    ///     version working directly on the species and patches, it is kept for checking that the core gives the
+    ///     same results.
+    ///   </para>
+    /// </remarks>
     public static class PopulationSimulation
     {
         private static readonly Compound Sunlight = SimulationParameters.Instance.GetCompound("sunlight");
@@ -18,15 +25,63 @@
         private static readonly Compound Oxytoxy = SimulationParameters.Instance.GetCompound("oxytoxy");
 
         public static void Simulate(SimulationConfiguration parameters)
+        {
+            var species = CopyInitialPopulationsToResults(parameters);
+            var patches = parameters.OriginalMap.Patches.Values.ToList();
+
+            var core = new PopulationSimulationCore(species.Count, patches.Count);
+
+            for (int i = 0; i < species.Count; ++i)
+            {
+                var microbeSpecies = (MicrobeSpecies)species[i];
+
+                core.SetSpecies(i, GetCompoundUseScore(microbeSpecies, Sunlight),
+                    GetCompoundUseScore(microbeSpecies, HydrogenSulfide), GetCompoundUseScore(microbeSpecies, Iron),
+                    GetCompoundUseScore(microbeSpecies, Glucose), GetPredationScore(microbeSpecies),
+                    microbeSpecies.Organelles.Count);
+            }
+
+            for (int patchIndex = 0; patchIndex < patches.Count; ++patchIndex)
+            {
+                var patch = patches[patchIndex];
+
+                GetPatchEnergies(patch, out var sunlight, out var hydrogenSulfide, out var iron, out var glucose);
+                core.SetPatchEnergies(patchIndex, sunlight, hydrogenSulfide, iron, glucose);
+
+                for (int i = 0; i < species.Count; ++i)
+                    core.SetPopulation(patchIndex, i, parameters.Results.GetPopulationInPatch(species[i], patch));
+            }
+
+            core.Run(parameters.StepsLeft);
+            parameters.StepsLeft = 0;
+
+            for (int patchIndex = 0; patchIndex < patches.Count; ++patchIndex)
+            {
+                for (int i = 0; i < species.Count; ++i)
+                {
+                    parameters.Results.AddPopulationResultForSpecies(species[i], patches[patchIndex],
+                        core.GetPopulation(patchIndex, i));
+                }
+            }
+        }
+
+        /// <summary>
+        ///   Runs the simulation without PopulationSimulationCore
+        /// </summary>
+        public static void SimulateReference(SimulationConfiguration parameters)
         {
             var random = new Random();
+            var arena = new CollectionArena();
 
             var speciesToSimulate = CopyInitialPopulationsToResults(parameters);
 
             while (parameters.StepsLeft > 0)
             {
-                RunSimulationStep(parameters, speciesToSimulate, random);
+                RunSimulationStep(parameters, speciesToSimulate, random, arena);
                 --parameters.StepsLeft;
+
+                // The collections are only needed during a single step
+                arena.Reset();
             }
         }
 
@@ -108,48 +163,43 @@
             return species;
         }
 
-        private static void RunSimulationStep(SimulationConfiguration parameters, List<Species> species, Random random)
+        private static void RunSimulationStep(SimulationConfiguration parameters, List<Species> species, Random random,
+            CollectionArena arena)
         {
             foreach (var entry in parameters.OriginalMap.Patches)
             {
+                var speciesInPatch = arena.BorrowList<MicrobeSpecies>();
+
                 // Simulate the species in each patch taking into account the already computed populations
-                SimulatePatchStep(parameters.Results, entry.Value,
-                    species.Where(item => parameters.Results.GetPopulationInPatch(item, entry.Value) > 0).ToList(),
-                    random);
+                foreach (var currentSpecies in species)
+                {
+                    // This algorithm version is for microbe species
+                    if (parameters.Results.GetPopulationInPatch(currentSpecies, entry.Value) > 0)
+                        speciesInPatch.Add((MicrobeSpecies)currentSpecies);
+                }
+
+                SimulatePatchStep(parameters.Results, entry.Value, speciesInPatch, random, arena);
             }
         }
 
         /// <summary>
         ///   The heart of the simulation that handles the processed parameters and calculates future populations.
         /// </summary>
-        private static void SimulatePatchStep(RunResults populations, Patch patch, List<Species> genericSpecies,
-            Random random)
+        private static void SimulatePatchStep(RunResults populations, Patch patch, List<MicrobeSpecies> species,
+            Random random, CollectionArena arena)
         {
             _ = random;
 
             // Skip if there aren't any species in this patch
-            if (genericSpecies.Count < 1)
+            if (species.Count < 1)
                 return;
 
-            // This algorithm version is for microbe species
-            var species = genericSpecies.Select(s => (MicrobeSpecies)s).ToList();
-
-            var biome = patch.Biome;
-
-            var sunlightInPatch = biome.Compounds[Sunlight].Dissolved * Constants.AUTO_EVO_SUNLIGHT_ENERGY_AMOUNT;
-
-            var hydrogenSulfideInPatch = biome.Compounds[HydrogenSulfide].Density
-                * biome.Compounds[HydrogenSulfide].Amount * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
-
-            var glucoseInPatch = (biome.Compounds[Glucose].Density
-                * biome.Compounds[Glucose].Amount
-                + patch.GetTotalChunkCompoundAmount(Glucose)) * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
-
-            var ironInPatch = patch.GetTotalChunkCompoundAmount(Iron) * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
+            GetPatchEnergies(patch, out var sunlightInPatch, out var hydrogenSulfideInPatch, out var ironInPatch,
+                out var glucoseInPatch);
 
             // Begin of new auto-evo prototype algorithm
 
-            var speciesEnergies = new Dictionary<MicrobeSpecies, float>(species.Count);
+            var speciesEnergies = arena.BorrowDictionary<MicrobeSpecies, float>();
 
             var totalPhotosynthesisScore = 0.0f;
             var totalChemosynthesisScore = 0.0f;
@@ -217,6 +267,26 @@
             }
         }
 
+        /// <summary>
+        ///   The energy each of the energy sources provides in a patch
+        /// </summary>
+        private static void GetPatchEnergies(Patch patch, out float sunlight, out float hydrogenSulfide,
+            out float iron, out float glucose)
+        {
+            var biome = patch.Biome;
+
+            sunlight = biome.Compounds[Sunlight].Dissolved * Constants.AUTO_EVO_SUNLIGHT_ENERGY_AMOUNT;
+
+            hydrogenSulfide = biome.Compounds[HydrogenSulfide].Density
+                * biome.Compounds[HydrogenSulfide].Amount * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
+
+            glucose = (biome.Compounds[Glucose].Density
+                * biome.Compounds[Glucose].Amount
+                + patch.GetTotalChunkCompoundAmount(Glucose)) * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
+
+            iron = patch.GetTotalChunkCompoundAmount(Iron) * Constants.AUTO_EVO_COMPOUND_ENERGY_AMOUNT;
+        }
+
         private static float GetPredationScore(MicrobeSpecies species)
         {
             var predationScore = 0.0f;
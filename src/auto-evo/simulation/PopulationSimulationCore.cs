@@ -0,0 +1,200 @@
+namespace AutoEvo
+{
+    using System;
+
+    /// <summary>
+    ///   The population simulation algorithm on flat arrays. The per species scores and the energy in each patch
+    ///   are calculated once by PopulationSimulation before running the steps, so the steps themselves don't touch
+    ///   the species organelles, dictionaries or the patch objects.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     This must give exactly the same results as PopulationSimulation.SimulateReference, the order of the
+    ///     floating point operations is kept the same for that. AutoEvoBenchmark checks that they match.
+    ///   </para>
+    /// </remarks>
+    public class PopulationSimulationCore
+    {
+        /// <summary>
+        ///   Sunlight, hydrogen sulfide, iron and glucose, in this order
+        /// </summary>
+        public const int ENERGY_SOURCES = 4;
+
+        /// <summary>
+        ///   How well each species uses each energy source, at species * ENERGY_SOURCES + source
+        /// </summary>
+        private readonly float[] useScores;
+
+        private readonly float[] predationScores;
+
+        /// <summary>
+        ///   Energy a species needs per unit of population
+        /// </summary>
+        private readonly double[] sizeDivisors;
+
+        /// <summary>
+        ///   Energy of each energy source in each patch, at patch * ENERGY_SOURCES + source
+        /// </summary>
+        private readonly float[] patchEnergies;
+
+        /// <summary>
+        ///   Populations at patch * SpeciesCount + species
+        /// </summary>
+        private readonly long[] populations;
+
+        private readonly float[] energies;
+        private readonly int[] present;
+
+        public PopulationSimulationCore(int speciesCount, int patchCount)
+        {
+            SpeciesCount = speciesCount;
+            PatchCount = patchCount;
+
+            useScores = new float[speciesCount * ENERGY_SOURCES];
+            predationScores = new float[speciesCount];
+            sizeDivisors = new double[speciesCount];
+            patchEnergies = new float[patchCount * ENERGY_SOURCES];
+            populations = new long[patchCount * speciesCount];
+
+            energies = new float[speciesCount];
+            present = new int[speciesCount];
+        }
+
+        public int SpeciesCount { get; }
+
+        public int PatchCount { get; }
+
+        public void SetSpecies(int species, float sunlightScore, float hydrogenSulfideScore, float ironScore,
+            float glucoseScore, float predationScore, int organelleCount)
+        {
+            int start = species * ENERGY_SOURCES;
+
+            useScores[start] = sunlightScore;
+            useScores[start + 1] = hydrogenSulfideScore;
+            useScores[start + 2] = ironScore;
+            useScores[start + 3] = glucoseScore;
+
+            predationScores[species] = predationScore;
+            sizeDivisors[species] = Math.Pow(organelleCount, 1.3f);
+        }
+
+        public void SetPatchEnergies(int patch, float sunlight, float hydrogenSulfide, float iron, float glucose)
+        {
+            int start = patch * ENERGY_SOURCES;
+
+            patchEnergies[start] = sunlight;
+            patchEnergies[start + 1] = hydrogenSulfide;
+            patchEnergies[start + 2] = iron;
+            patchEnergies[start + 3] = glucose;
+        }
+
+        public long GetPopulation(int patch, int species)
+        {
+            return populations[patch * SpeciesCount + species];
+        }
+
+        /// <summary>
+        ///   Sets the starting population of a species in a patch. Negative values (possible after migrations) are
+        ///   kept as they are, like in SimulateReference, as species without positive population aren't simulated.
+        /// </summary>
+        public void SetPopulation(int patch, int species, long population)
+        {
+            populations[patch * SpeciesCount + species] = population;
+        }
+
+        /// <summary>
+        ///   Runs the simulation steps, updating the populations
+        /// </summary>
+        public void Run(int steps)
+        {
+            for (int step = 0; step < steps; ++step)
+            {
+                for (int patch = 0; patch < PatchCount; ++patch)
+                    SimulatePatchStep(patch);
+            }
+        }
+
+        private void SimulatePatchStep(int patch)
+        {
+            int populationStart = patch * SpeciesCount;
+
+            // Only the species that are in the patch take part
+            int presentCount = 0;
+
+            for (int species = 0; species < SpeciesCount; ++species)
+            {
+                if (populations[populationStart + species] > 0)
+                    present[presentCount++] = species;
+            }
+
+            if (presentCount < 1)
+                return;
+
+            var totalPhotosynthesisScore = 0.0f;
+            var totalChemosynthesisScore = 0.0f;
+            var totalChemolithautotrophyScore = 0.0f;
+            var totalGlucoseScore = 0.0f;
+
+            var totalPredationScore = 0.0f;
+
+            for (int i = 0; i < presentCount; ++i)
+            {
+                int scoreStart = present[i] * ENERGY_SOURCES;
+
+                totalPhotosynthesisScore += useScores[scoreStart];
+                totalChemosynthesisScore += useScores[scoreStart + 1];
+                totalChemolithautotrophyScore += useScores[scoreStart + 2];
+                totalGlucoseScore += useScores[scoreStart + 3];
+                totalPredationScore += predationScores[present[i]];
+            }
+
+            // Avoid division by 0
+            totalPhotosynthesisScore = Math.Max(MathUtils.EPSILON, totalPhotosynthesisScore);
+            totalChemosynthesisScore = Math.Max(MathUtils.EPSILON, totalChemosynthesisScore);
+            totalChemolithautotrophyScore = Math.Max(MathUtils.EPSILON, totalChemolithautotrophyScore);
+            totalGlucoseScore = Math.Max(MathUtils.EPSILON, totalGlucoseScore);
+            totalPredationScore = Math.Max(MathUtils.EPSILON, totalPredationScore);
+
+            int energyStart = patch * ENERGY_SOURCES;
+
+            // Calculate the share of environmental energy captured by each species
+            var energyAvailableForPredation = 0.0f;
+
+            for (int i = 0; i < presentCount; ++i)
+            {
+                int scoreStart = present[i] * ENERGY_SOURCES;
+
+                var currentSpeciesEnergy = 0.0f;
+
+                currentSpeciesEnergy += patchEnergies[energyStart] * useScores[scoreStart] / totalPhotosynthesisScore;
+                currentSpeciesEnergy += patchEnergies[energyStart + 1] * useScores[scoreStart + 1] /
+                    totalChemosynthesisScore;
+                currentSpeciesEnergy += patchEnergies[energyStart + 2] * useScores[scoreStart + 2] /
+                    totalChemolithautotrophyScore;
+                currentSpeciesEnergy += patchEnergies[energyStart + 3] * useScores[scoreStart + 3] /
+                    totalGlucoseScore;
+
+                energyAvailableForPredation += currentSpeciesEnergy * Constants.AUTO_EVO_PREDATION_ENERGY_MULTIPLIER;
+                energies[i] = currentSpeciesEnergy;
+            }
+
+            // Calculate the share of predation done by each species
+            // Then update populations
+            for (int i = 0; i < presentCount; ++i)
+            {
+                int species = present[i];
+
+                energies[i] += energyAvailableForPredation * predationScores[species] / totalPredationScore;
+                energies[i] -= energyAvailableForPredation / presentCount;
+
+                var newPopulation = (long)(energies[i] / sizeDivisors[species]);
+
+                // Can't survive without enough population
+                if (newPopulation < Constants.AUTO_EVO_MINIMUM_VIABLE_POPULATION)
+                    newPopulation = 0;
+
+                populations[populationStart + species] = newPopulation;
+            }
+        }
+    }
+}
@@ -11,45 +11,48 @@
         private PatchMap map;
         private Species species;
 
-        private Random random = new Random();
+        private Random random;
 
-        public FindBestMigration(PatchMap map, Species species, int migrationsToTry, bool allowNoMigration)
-            : base(migrationsToTry, allowNoMigration)
+        public FindBestMigration(PatchMap map, Species species, Random random, SimulationBudget budget,
+            int allocation, bool allowNoMigration)
+            : base(budget, allocation, allowNoMigration)
         {
             this.map = map;
             this.species = species;
+            this.random = random;
         }
 
-        protected override void OnBestResultFound(RunResults results, IAttemptResult bestVariant)
+        protected override void OnBestVariantFound(RunResults results, object bestVariant)
         {
-            var variant = (AttemptResult)bestVariant;
-
-            if (variant.Migration == null)
+            if (bestVariant == null)
                 return;
 
-            results.AddMigrationResultForSpecies(species, variant.Migration);
+            results.AddMigrationResultForSpecies(species, (SpeciesMigration)bestVariant);
         }
 
-        protected override IAttemptResult TryCurrentVariant()
+        protected override object CreateVariant()
         {
-            var config = new SimulationConfiguration(map, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS);
+            return GetRandomMigration();
+        }
 
-            PopulationSimulation.Simulate(config);
+        protected override long EvaluateCurrentVariant(int steps)
+        {
+            var config = new SimulationConfiguration(map, steps);
 
-            var population = config.Results.GetGlobalPopulation(species);
+            PopulationSimulation.Simulate(config);
 
-            return new AttemptResult(null, population);
+            return config.Results.GetGlobalPopulation(species);
         }
 
-        protected override IAttemptResult TryVariant()
+        protected override long EvaluateVariant(object variant, int steps)
         {
-            var migration = GetRandomMigration();
+            var migration = (SpeciesMigration)variant;
 
             // Move generation can randomly fail
             if (migration == null)
-                return new AttemptResult(null, -1);
+                return -1;
 
-            var config = new SimulationConfiguration(map, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS);
+            var config = new SimulationConfiguration(map, steps);
             config.Migrations.Add(new Tuple<Species, SpeciesMigration>(species, migration));
 
             // TODO: this could be faster to just simulate the source and
@@ -58,9 +61,7 @@
             // simulation anyway)
             PopulationSimulation.Simulate(config);
 
-            var population = config.Results.GetGlobalPopulation(species);
-
-            return new AttemptResult(migration, population);
+            return config.Results.GetGlobalPopulation(species);
         }
 
         /// <summary>
@@ -118,17 +119,5 @@
             // Could not find a valid move
             return null;
         }
-
-        private class AttemptResult : IAttemptResult
-        {
-            public AttemptResult(SpeciesMigration migration, long score)
-            {
-                Migration = migration;
-                Score = score;
-            }
-
-            public SpeciesMigration Migration { get; }
-            public long Score { get; }
-        }
     }
 }
@@ -1,5 +1,7 @@
 ﻿namespace AutoEvo
 {
+    using System;
+
     /// <summary>
     ///   Step that finds the best mutation for a single species
     /// </summary>
@@ -8,58 +10,50 @@
         private PatchMap map;
         private Species species;
 
-        private Mutations mutations = new Mutations();
+        private Mutations mutations;
 
-        public FindBestMutation(PatchMap map, Species species, int mutationsToTry, bool allowNoMutation)
-            : base(mutationsToTry, allowNoMutation)
+        public FindBestMutation(PatchMap map, Species species, Random random, SimulationBudget budget,
+            int allocation, bool allowNoMutation)
+            : base(budget, allocation, allowNoMutation)
         {
             this.map = map;
             this.species = species;
+            mutations = new Mutations(random);
         }
 
-        protected override void OnBestResultFound(RunResults results, IAttemptResult bestVariant)
+        protected override void OnBestVariantFound(RunResults results, object bestVariant)
         {
-            results.AddMutationResultForSpecies(species, ((AttemptResult)bestVariant).Mutation);
+            results.AddMutationResultForSpecies(species, (Species)bestVariant);
         }
 
-        protected override IAttemptResult TryCurrentVariant()
+        protected override object CreateVariant()
         {
-            var config = new SimulationConfiguration(map, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS);
+            var mutated = (MicrobeSpecies)species.Clone();
+            mutations.CreateMutatedSpecies((MicrobeSpecies)species, mutated);
+            return mutated;
+        }
 
-            PopulationSimulation.Simulate(config);
+        protected override long EvaluateCurrentVariant(int steps)
+        {
+            var config = new SimulationConfiguration(map, steps);
 
-            var population = config.Results.GetGlobalPopulation(species);
+            PopulationSimulation.Simulate(config);
 
-            return new AttemptResult(null, population);
+            return config.Results.GetGlobalPopulation(species);
         }
 
-        protected override IAttemptResult TryVariant()
+        protected override long EvaluateVariant(object variant, int steps)
         {
-            var mutated = (MicrobeSpecies)species.Clone();
-            mutations.CreateMutatedSpecies((MicrobeSpecies)species, mutated);
+            var mutated = (Species)variant;
 
-            var config = new SimulationConfiguration(map, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS);
+            var config = new SimulationConfiguration(map, steps);
 
             config.ExcludedSpecies.Add(species);
             config.ExtraSpecies.Add(mutated);
 
             PopulationSimulation.Simulate(config);
 
-            var population = config.Results.GetGlobalPopulation(mutated);
-
-            return new AttemptResult(mutated, population);
-        }
-
-        private class AttemptResult : IAttemptResult
-        {
-            public AttemptResult(Species mutation, long score)
-            {
-                Mutation = mutation;
-                Score = score;
-            }
-
-            public Species Mutation { get; }
-            public long Score { get; }
+            return config.Results.GetGlobalPopulation(mutated);
         }
     }
 }
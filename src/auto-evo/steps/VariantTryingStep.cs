@@ -1,82 +1,277 @@
 ﻿namespace AutoEvo
 {
+    using System;
+    using System.Collections.Generic;
+
     /// <summary>
-    ///   Base helper class for steps trying a fixed number of variant solutions and picking the best
+    ///   Base helper class for steps trying variant solutions and picking the best. The variants are compared with
+    ///   successive halving within a share of the SimulationBudget.
     /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     All candidates are first simulated for a few steps, then the better half is simulated for more steps and
+    ///     so on until the last round uses the full AUTO_EVO_VARIANT_SIMULATION_STEPS. The number of candidates is
+    ///     the most that fits in the budget share. If one candidate clearly wins a round the rest of the rounds are
+    ///     skipped, and if the best two are very close after the last round a few more candidates are tried with
+    ///     steps from the unused pool. If the share is too small to compare even two candidates nothing is
+    ///     simulated and the whole share is returned to the pool.
+    ///   </para>
+    /// </remarks>
     public abstract class VariantTryingStep : IRunStep
     {
-        private int variantsToTry;
-        private bool tryCurrentVariant;
+        /// <summary>
+        ///   How many simulation steps the candidates are simulated for in each round
+        /// </summary>
+        private static readonly int[] RoundSteps =
+        {
+            Math.Max(1, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS / 4),
+            Math.Max(1, Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS / 2),
+            Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS,
+        };
+
+        private readonly SimulationBudget budget;
+        private readonly int allocation;
+        private readonly bool tryCurrentVariant;
+
+        /// <summary>
+        ///   Candidates still to be simulated in the current round
+        /// </summary>
+        private readonly List<Candidate> pending = new List<Candidate>();
+
+        /// <summary>
+        ///   Candidates that have been simulated in the current round
+        /// </summary>
+        private readonly List<Candidate> evaluated = new List<Candidate>();
 
-        private IAttemptResult currentBest;
+        private bool started;
+        private int round;
+        private bool extraCandidatesTried;
+        private int spent;
+        private int createdCandidates;
+        private int evaluations;
 
-        protected VariantTryingStep(int variantsToTry, bool tryCurrentVariant)
+        protected VariantTryingStep(SimulationBudget budget, int allocation, bool tryCurrentVariant)
         {
-            this.variantsToTry = variantsToTry;
+            this.budget = budget;
+            this.allocation = allocation;
             this.tryCurrentVariant = tryCurrentVariant;
+
+            CandidateCount = CalculateCandidateCount(allocation);
         }
 
-        public interface IAttemptResult
+        /// <summary>
+        ///   How many candidates (including the current variant if it is tried) are compared. 1 when the
+        ///   allocation is too small for a comparison.
+        /// </summary>
+        public int CandidateCount { get; }
+
+        public int TotalSteps
         {
-            long Score { get; }
-        }
+            get
+            {
+                if (CandidateCount < 2)
+                    return 1;
 
-        public int TotalSteps => (tryCurrentVariant ? 1 : 0) + variantsToTry;
+                if (!started)
+                    return CountEvaluations(CandidateCount, 0);
+
+                return evaluations + pending.Count +
+                    CountEvaluations(GetSurvivorCount(pending.Count + evaluated.Count), round + 1);
+            }
+        }
 
         public bool RunStep(RunResults results)
         {
-            bool ran = false;
+            if (CandidateCount < 2)
+            {
+                // A single candidate has nothing to be compared against so it is used without simulating it. If
+                // changes aren't required that is the current variant.
+                budget.ReturnUnused(allocation);
+                OnBestVariantFound(results, tryCurrentVariant ? null : CreateVariant());
+                return true;
+            }
 
-            if (tryCurrentVariant)
+            if (!started)
             {
-                var result = TryCurrentVariant();
+                started = true;
 
-                if (currentBest == null || result.Score > currentBest.Score)
-                {
-                    currentBest = result;
-                }
+                if (tryCurrentVariant)
+                    pending.Add(new Candidate(createdCandidates++, null, true));
 
-                tryCurrentVariant = false;
-                ran = true;
+                while (createdCandidates < CandidateCount)
+                    pending.Add(new Candidate(createdCandidates++, CreateVariant(), false));
             }
 
-            if (variantsToTry > 0 && !ran)
-            {
-                var result = TryVariant();
+            // Each call simulates one candidate to keep the calls short
+            var candidate = pending[pending.Count - 1];
+            pending.RemoveAt(pending.Count - 1);
 
-                if (currentBest == null || result.Score > currentBest.Score)
-                {
-                    currentBest = result;
-                }
+            int steps = RoundSteps[round];
 
-                --variantsToTry;
-            }
+            candidate.Score = candidate.IsCurrent ?
+                EvaluateCurrentVariant(steps) :
+                EvaluateVariant(candidate.Variant, steps);
+            spent += steps;
+            ++evaluations;
 
-            if (!tryCurrentVariant && variantsToTry <= 0)
-            {
-                // Store the best result
-                OnBestResultFound(results, currentBest);
-                return true;
-            }
+            evaluated.Add(candidate);
 
-            return false;
+            if (pending.Count > 0)
+                return false;
+
+            if (!FinishRound())
+                return false;
+
+            budget.ReturnUnused(allocation - spent);
+            OnBestVariantFound(results, evaluated[0].Variant);
+            return true;
         }
 
         /// <summary>
-        ///   Generate and try a random variant
+        ///   Creates a random variant to try
+        /// </summary>
+        protected abstract object CreateVariant();
+
+        /// <summary>
+        ///   Simulates the "no action" choice
         /// </summary>
-        protected abstract IAttemptResult TryVariant();
+        /// <param name="steps">Number of simulation steps to run</param>
+        /// <returns>The score, higher is better</returns>
+        protected abstract long EvaluateCurrentVariant(int steps);
 
         /// <summary>
-        ///   Try the "no action" choice
+        ///   Simulates a variant made by CreateVariant
         /// </summary>
-        protected abstract IAttemptResult TryCurrentVariant();
+        /// <param name="variant">The variant to simulate</param>
+        /// <param name="steps">Number of simulation steps to run</param>
+        /// <returns>The score, higher is better</returns>
+        protected abstract long EvaluateVariant(object variant, int steps);
 
         /// <summary>
         ///   Called after the best attempted variant is determined
         /// </summary>
         /// <param name="results">Results to apply the found solution to.</param>
-        /// <param name="bestVariant">Best variant found.</param>
-        protected abstract void OnBestResultFound(RunResults results, IAttemptResult bestVariant);
+        /// <param name="bestVariant">Best variant found, null if the current variant was the best.</param>
+        protected abstract void OnBestVariantFound(RunResults results, object bestVariant);
+
+        /// <summary>
+        ///   How many of the candidates of a round go on to the next one. At least two are kept so that the
+        ///   last round always compares candidates at the full simulation length.
+        /// </summary>
+        private static int GetSurvivorCount(int candidates)
+        {
+            return Math.Min(candidates, Math.Max(2, (candidates + 1) / 2));
+        }
+
+        /// <summary>
+        ///   Simulation steps needed to compare a number of candidates
+        /// </summary>
+        private static int CalculateScheduleCost(int candidates)
+        {
+            int cost = 0;
+
+            for (int i = 0; i < RoundSteps.Length; ++i)
+            {
+                cost += candidates * RoundSteps[i];
+                candidates = GetSurvivorCount(candidates);
+            }
+
+            return cost;
+        }
+
+        private static int CalculateCandidateCount(int allocation)
+        {
+            // Running a comparison that doesn't fit would go over the budget
+            if (CalculateScheduleCost(2) > allocation)
+                return 1;
+
+            int count = 2;
+
+            while (count < Constants.AUTO_EVO_MAX_VARIANT_CANDIDATES && CalculateScheduleCost(count + 1) <= allocation)
+                ++count;
+
+            return count;
+        }
+
+        /// <summary>
+        ///   Simulations needed to compare a number of candidates starting from a round
+        /// </summary>
+        private static int CountEvaluations(int candidates, int fromRound)
+        {
+            int count = 0;
+
+            for (int i = fromRound; i < RoundSteps.Length; ++i)
+            {
+                count += candidates;
+                candidates = GetSurvivorCount(candidates);
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        ///   Sorts the evaluated candidates and sets up the next round
+        /// </summary>
+        /// <returns>True when the best candidate is found, it is then the first in evaluated</returns>
+        private bool FinishRound()
+        {
+            // Ties go to the earlier candidate, so the current variant is preferred over equally good changes
+            evaluated.Sort((first, second) =>
+            {
+                int result = second.Score.CompareTo(first.Score);
+                return result != 0 ? result : first.Index.CompareTo(second.Index);
+            });
+
+            if (evaluated.Count < 2)
+                return true;
+
+            var best = evaluated[0].Score;
+            var secondBest = evaluated[1].Score;
+
+            if (round < RoundSteps.Length - 1)
+            {
+                if (best > 0 && best >= secondBest * Constants.AUTO_EVO_CLEAR_WIN_SCORE_RATIO)
+                    return true;
+
+                pending.AddRange(evaluated.GetRange(0, GetSurvivorCount(evaluated.Count)));
+                evaluated.Clear();
+                ++round;
+                return false;
+            }
+
+            if (extraCandidatesTried || secondBest < best * (1 - Constants.AUTO_EVO_CLOSE_SCORE_FRACTION))
+                return true;
+
+            // The best ones are close, try a few more at full length if there are steps left over
+            extraCandidatesTried = true;
+
+            int extraCost = Constants.AUTO_EVO_EXTRA_CANDIDATES_FOR_CLOSE_SCORES * RoundSteps[round];
+
+            if (!budget.TryTakeUnused(extraCost))
+                return true;
+
+            // These are paid from the pool and not from the share of this step
+            spent -= extraCost;
+
+            for (int i = 0; i < Constants.AUTO_EVO_EXTRA_CANDIDATES_FOR_CLOSE_SCORES; ++i)
+                pending.Add(new Candidate(createdCandidates++, CreateVariant(), false));
+
+            return false;
+        }
+
+        private class Candidate
+        {
+            public Candidate(int index, object variant, bool isCurrent)
+            {
+                Index = index;
+                Variant = variant;
+                IsCurrent = isCurrent;
+            }
+
+            public int Index { get; }
+            public object Variant { get; }
+            public bool IsCurrent { get; }
+            public long Score { get; set; }
+        }
     }
 }
@@ -0,0 +1,86 @@
+using System.Collections.Generic;
+using System.Linq;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Simulates a batch of seeded freebuild worlds in parallel, for auto-evo balancing experiments. Run the scene
+///   directly, it writes the summary of every world to Constants.BENCHMARK_FOLDER and quits, with exit code 1 if
+///   some world didn't complete.
+/// </summary>
+public class AutoEvoBatchBenchmark : Node
+{
+    private const string RESULT_FILE_NAME = "auto_evo_batch.json";
+
+    [Export]
+    public int FirstSeed = 1;
+
+    [Export]
+    public int Worlds = 32;
+
+    [Export]
+    public int Generations = 20;
+
+    private BatchWorldSimulator simulator;
+
+    private float timeSinceStatus;
+
+    public override void _Ready()
+    {
+        simulator = new BatchWorldSimulator(Enumerable.Range(FirstSeed, Worlds), Generations);
+        simulator.Start();
+    }
+
+    public override void _Process(float delta)
+    {
+        if (!simulator.Finished)
+        {
+            timeSinceStatus += delta;
+
+            if (timeSinceStatus > 1)
+            {
+                timeSinceStatus = 0;
+                GD.Print("Auto-evo batch: ", simulator.Status);
+            }
+
+            return;
+        }
+
+        var summaries = simulator.GetSummaries();
+
+        WriteResults(summaries);
+
+        GD.Print("Auto-evo batch: ", simulator.WorldCount, " worlds of ", Generations, " generations in ",
+            simulator.Seconds.ToString("F1"), " seconds, ", simulator.WorldsPerSecond.ToString("F2"),
+            " worlds per second");
+
+        GetTree().Quit(summaries.Any(summary => summary.Error != null) ? 1 : 0);
+        SetProcess(false);
+    }
+
+    public override void _ExitTree()
+    {
+        simulator?.Abort();
+    }
+
+    private void WriteResults(List<BatchWorldSimulator.WorldSummary> summaries)
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write benchmark results to: ", path);
+                return;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(summaries, Formatting.Indented));
+            file.Close();
+        }
+
+        GD.Print("Auto-evo batch summaries written to: ", path);
+    }
+}
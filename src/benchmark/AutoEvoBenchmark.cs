@@ -0,0 +1,153 @@
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using AutoEvo;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Checks that PopulationSimulation.Simulate gives the same populations as PopulationSimulation.SimulateReference
+///   and measures how long both take. Run the scene directly, it writes the results to Constants.BENCHMARK_FOLDER
+///   and quits, with exit code 1 if any population differed.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The corpus is a number of freebuild worlds with random species. For each world the whole map is simulated
+///     for one step and for the variant step count, and then each species is replaced with a mutated variant like
+///     FindBestMutation does.
+///   </para>
+/// </remarks>
+public class AutoEvoBenchmark : Node
+{
+    private const string RESULT_FILE_NAME = "auto_evo_benchmark.json";
+
+    [Export]
+    public int Worlds = 5;
+
+    /// <summary>
+    ///   How many times each configuration is simulated for the timing
+    /// </summary>
+    [Export]
+    public int Iterations = 10;
+
+    private readonly List<CaseResult> results = new List<CaseResult>();
+
+    public override void _Ready()
+    {
+        for (int i = 0; i < Worlds; ++i)
+        {
+            var world = new GameWorld(new WorldGenerationSettings());
+            world.GenerateRandomSpeciesForFreeBuild();
+
+            RunCase(world, "map", 1, null, null);
+            RunCase(world, "map", Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS, null, null);
+
+            foreach (var species in world.Map.FindAllSpeciesWithPopulation())
+            {
+                RunCase(world, "variant", Constants.AUTO_EVO_VARIANT_SIMULATION_STEPS, species,
+                    world.CreateMutatedSpecies(species));
+            }
+        }
+
+        WriteResults();
+
+        int mismatches = results.Sum(result => result.Mismatches);
+
+        GD.Print("Auto-evo benchmark: ", results.Count, " cases, reference: ",
+            results.Sum(result => result.ReferenceMilliseconds), " ms, core: ",
+            results.Sum(result => result.CoreMilliseconds), " ms, mismatched populations: ", mismatches);
+
+        GetTree().Quit(mismatches > 0 ? 1 : 0);
+    }
+
+    private static SimulationConfiguration CreateConfiguration(GameWorld world, int steps, Species excluded,
+        Species variant)
+    {
+        var config = new SimulationConfiguration(world.Map, steps);
+
+        if (excluded != null)
+        {
+            config.ExcludedSpecies.Add(excluded);
+            config.ExtraSpecies.Add(variant);
+        }
+
+        return config;
+    }
+
+    private void RunCase(GameWorld world, string name, int steps, Species excluded, Species variant)
+    {
+        var result = new CaseResult { Case = name, Steps = steps };
+
+        SimulationConfiguration reference = null;
+        SimulationConfiguration core = null;
+
+        var stopwatch = Stopwatch.StartNew();
+
+        for (int i = 0; i < Iterations; ++i)
+        {
+            reference = CreateConfiguration(world, steps, excluded, variant);
+            PopulationSimulation.SimulateReference(reference);
+        }
+
+        result.ReferenceMilliseconds = stopwatch.Elapsed.TotalMilliseconds / Iterations;
+        stopwatch.Restart();
+
+        for (int i = 0; i < Iterations; ++i)
+        {
+            core = CreateConfiguration(world, steps, excluded, variant);
+            PopulationSimulation.Simulate(core);
+        }
+
+        result.CoreMilliseconds = stopwatch.Elapsed.TotalMilliseconds / Iterations;
+
+        var simulatedSpecies = world.Map.FindAllSpeciesWithPopulation().Where(species => species != excluded)
+            .ToList();
+
+        if (variant != null)
+            simulatedSpecies.Add(variant);
+
+        foreach (var species in simulatedSpecies)
+        {
+            foreach (var patch in world.Map.Patches.Values)
+            {
+                if (reference.Results.GetPopulationInPatch(species, patch) !=
+                    core.Results.GetPopulationInPatch(species, patch))
+                {
+                    ++result.Mismatches;
+                }
+            }
+        }
+
+        results.Add(result);
+    }
+
+    private void WriteResults()
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write benchmark results to: ", path);
+                return;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(results, Formatting.Indented));
+            file.Close();
+        }
+
+        GD.Print("Auto-evo benchmark results written to: ", path);
+    }
+
+    public class CaseResult
+    {
+        public string Case { get; set; }
+        public int Steps { get; set; }
+        public double ReferenceMilliseconds { get; set; }
+        public double CoreMilliseconds { get; set; }
+        public int Mismatches { get; set; }
+    }
+}
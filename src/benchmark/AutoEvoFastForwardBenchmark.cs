@@ -0,0 +1,73 @@
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Fast forwards a freebuild world for a number of auto-evo generations, for balancing auto-evo over long time
+///   spans. Run the scene directly, it writes the checkpoint of every generation to Constants.BENCHMARK_FOLDER and
+///   quits, with exit code 1 if the fast forward didn't complete.
+/// </summary>
+public class AutoEvoFastForwardBenchmark : Node
+{
+    private const string RESULT_FILE_NAME = "auto_evo_fast_forward.json";
+
+    [Export]
+    public int Generations = 50;
+
+    private AutoEvoFastForward fastForward;
+
+    private float timeSinceStatus;
+
+    public override void _Ready()
+    {
+        var world = new GameWorld(new WorldGenerationSettings());
+        world.GenerateRandomSpeciesForFreeBuild();
+
+        // Like in freebuild the player species is allowed to go extinct
+        fastForward = world.StartAutoEvoFastForward(Generations, true);
+    }
+
+    public override void _Process(float delta)
+    {
+        if (!fastForward.Finished)
+        {
+            timeSinceStatus += delta;
+
+            if (timeSinceStatus > 1)
+            {
+                timeSinceStatus = 0;
+                GD.Print("Auto-evo fast forward: ", fastForward.Status);
+            }
+
+            return;
+        }
+
+        WriteResults();
+
+        GD.Print("Auto-evo fast forward: ", fastForward.CompletedGenerations, " generations, ",
+            fastForward.GenerationsPerSecond.ToString("F2"), " generations per second");
+
+        GetTree().Quit(fastForward.Aborted ? 1 : 0);
+        SetProcess(false);
+    }
+
+    private void WriteResults()
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write benchmark results to: ", path);
+                return;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(fastForward.GetCheckpoints(), Formatting.Indented));
+            file.Close();
+        }
+
+        GD.Print("Auto-evo fast forward checkpoints written to: ", path);
+    }
+}
@@ -0,0 +1,215 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Godot;
+using Newtonsoft.Json;
+using Vector4 = System.Numerics.Vector4;
+
+/// <summary>
+///   Checks that the pointer versions of the CloudKernels give the same results as the checked versions and
+///   measures how long each takes. Run the scene directly, it writes the results to Constants.BENCHMARK_FOLDER and
+///   quits, with exit code 1 if any of the kernels gave different results.
+/// </summary>
+public class CloudKernelBenchmark : Node
+{
+    private const string RESULT_FILE_NAME = "cloud_kernel_benchmark.json";
+
+    /// <summary>
+    ///   Largest allowed difference between the results of the two versions of a kernel
+    /// </summary>
+    private const float TOLERANCE = 0.0001f;
+
+    /// <summary>
+    ///   The cloud sizes (cells per side) to run the kernels with
+    /// </summary>
+    [Export]
+    public int[] Sizes = { 100, 200, 400 };
+
+    /// <summary>
+    ///   How many times each kernel is ran for the timing
+    /// </summary>
+    [Export]
+    public int Iterations = 50;
+
+    private readonly List<KernelResult> results = new List<KernelResult>();
+
+    private readonly Random random = new Random(42);
+
+    private FluidSystem fluid;
+
+    public override void _Ready()
+    {
+        fluid = new FluidSystem(this);
+
+        foreach (var size in Sizes)
+        {
+            var density = CreateDensity(size);
+
+            RunDiffuse(density, size);
+            RunAdvect(density, size, false);
+            RunAdvect(density, size, true);
+            RunWriteTexture(density, size);
+        }
+
+        WriteResults();
+
+        var failed = results.Where(result => result.MaxDifference > TOLERANCE).ToList();
+
+        foreach (var result in failed)
+        {
+            GD.PrintErr("Cloud kernel ", result.Kernel, " gave different results with size ", result.Size,
+                ", difference: ", result.MaxDifference);
+        }
+
+        GetTree().Quit(failed.Count > 0 ? 1 : 0);
+    }
+
+    private static float MaxDifference(Vector4[,] first, Vector4[,] second)
+    {
+        float max = 0;
+
+        for (int x = 0; x < first.GetLength(0); ++x)
+        {
+            for (int y = 0; y < first.GetLength(1); ++y)
+            {
+                var difference = Vector4.Abs(first[x, y] - second[x, y]);
+                max = Math.Max(max, Math.Max(Math.Max(difference.X, difference.Y),
+                    Math.Max(difference.Z, difference.W)));
+            }
+        }
+
+        return max;
+    }
+
+    private Vector4[,] CreateDensity(int size)
+    {
+        var density = new Vector4[size, size];
+
+        for (int x = 0; x < size; ++x)
+        {
+            for (int y = 0; y < size; ++y)
+            {
+                // Leave some cells empty like in the real clouds, the advection skips those
+                if (random.Next(3) == 0)
+                    continue;
+
+                density[x, y] = new Vector4(RandomAmount(), RandomAmount(), RandomAmount(), RandomAmount());
+            }
+        }
+
+        return density;
+    }
+
+    private float RandomAmount()
+    {
+        return (float)random.NextDouble() * 10.0f;
+    }
+
+    private void RunDiffuse(Vector4[,] density, int size)
+    {
+        var checkedResult = new Vector4[size, size];
+        var pointerResult = new Vector4[size, size];
+
+        var result = new KernelResult { Kernel = "diffuse", Size = size };
+
+        result.CheckedMilliseconds = Measure(() =>
+            CloudKernels.DiffuseChecked(density, checkedResult, size, 0, 0, size, size, 0.5f));
+        result.PointerMilliseconds = Measure(() =>
+            CloudKernels.DiffusePointers(density, pointerResult, size, 0, 0, size, size, 0.5f));
+
+        result.MaxDifference = MaxDifference(checkedResult, pointerResult);
+        AddResult(result);
+    }
+
+    private void RunAdvect(Vector4[,] density, int size, bool clampToArea)
+    {
+        var checkedResult = new Vector4[size, size];
+        var pointerResult = new Vector4[size, size];
+
+        var result = new KernelResult { Kernel = clampToArea ? "advect clamped" : "advect wrapping", Size = size };
+
+        // The clamped version is used for the inner parts of the clouds
+        int start = clampToArea ? size / 4 : 0;
+        int width = clampToArea ? size / 2 : size;
+
+        // The results add up over the iterations, so the buffers are compared after the same amount of runs
+        result.CheckedMilliseconds = Measure(() => CloudKernels.AdvectChecked(density, checkedResult, size, start,
+            start, width, width, 100.0f, fluid, Vector2.Zero, 2, 0.0525f, clampToArea));
+        result.PointerMilliseconds = Measure(() => CloudKernels.AdvectPointers(density, pointerResult, size, start,
+            start, width, width, 100.0f, fluid, Vector2.Zero, 2, 0.0525f, clampToArea));
+
+        result.MaxDifference = MaxDifference(checkedResult, pointerResult);
+        AddResult(result);
+    }
+
+    private void RunWriteTexture(Vector4[,] density, int size)
+    {
+        var checkedResult = new byte[size * size * Constants.CLOUD_TEXTURE_BYTES_PER_PIXEL];
+        var pointerResult = new byte[checkedResult.Length];
+
+        var result = new KernelResult { Kernel = "write texture", Size = size };
+
+        result.CheckedMilliseconds = Measure(() =>
+            CloudKernels.WriteTextureChecked(density, checkedResult, size, 0, 0, size, size));
+        result.PointerMilliseconds = Measure(() =>
+            CloudKernels.WriteTexturePointers(density, pointerResult, size, 0, 0, size, size));
+
+        result.MaxDifference = checkedResult.SequenceEqual(pointerResult) ? 0 : float.MaxValue;
+        AddResult(result);
+    }
+
+    /// <summary>
+    ///   Runs the action Iterations times after one warm-up run
+    /// </summary>
+    /// <returns>The average time of a run in milliseconds</returns>
+    private double Measure(Action action)
+    {
+        action();
+
+        var stopwatch = Stopwatch.StartNew();
+
+        for (int i = 0; i < Iterations; ++i)
+            action();
+
+        return stopwatch.Elapsed.TotalMilliseconds / Iterations;
+    }
+
+    private void AddResult(KernelResult result)
+    {
+        results.Add(result);
+
+        GD.Print($"Cloud kernel benchmark: {result.Kernel} with size {result.Size}, " +
+            $"checked: {result.CheckedMilliseconds:F3} ms, pointers: {result.PointerMilliseconds:F3} ms");
+    }
+
+    private void WriteResults()
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write benchmark results to: ", path);
+                return;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(results, Formatting.Indented));
+            file.Close();
+        }
+
+        GD.Print("Cloud kernel benchmark results written to: ", path);
+    }
+
+    public class KernelResult
+    {
+        public string Kernel { get; set; }
+        public int Size { get; set; }
+        public double CheckedMilliseconds { get; set; }
+        public double PointerMilliseconds { get; set; }
+        public float MaxDifference { get; set; }
+    }
+}
@@ -0,0 +1,256 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Measures how the physics step time scales with the number of bodies, comparing the Godot physics to the
+///   planar physics. Run the scene directly, it writes the results to Constants.BENCHMARK_FOLDER and quits.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The planar step is timed directly. The Godot physics server steps after all the _PhysicsProcess calls,
+///     so its step is timed from the end of _PhysicsProcess to the start of the next _Process.
+///   </para>
+/// </remarks>
+public class PhysicsBenchmark : Node
+{
+    private const string RESULT_FILE_NAME = "physics_benchmark.json";
+
+    /// <summary>
+    ///   The body counts to run the benchmark with
+    /// </summary>
+    [Export]
+    public int[] BodyCounts = { 100, 250, 500, 1000, 2000 };
+
+    /// <summary>
+    ///   Physics frames to ignore after spawning before starting measurements
+    /// </summary>
+    [Export]
+    public int WarmupFrames = 30;
+
+    [Export]
+    public int MeasuredFrames = 300;
+
+    /// <summary>
+    ///   Area reserved for each body. Keeps the density, and so the amount of contacts, the same between runs.
+    /// </summary>
+    [Export]
+    public float AreaPerBody = 40.0f;
+
+    [Export]
+    public float BodyRadius = 1.5f;
+
+    private readonly List<RunResult> results = new List<RunResult>();
+    private readonly List<float> frameTimes = new List<float>();
+
+    private readonly Stopwatch stepStopwatch = new Stopwatch();
+
+    private Random random;
+
+    private Spatial bodiesRoot;
+    private PlanarPhysicsSystem planarPhysics;
+
+    private int currentCountIndex;
+    private bool currentIsPlanar;
+    private int framesInRun;
+
+    private AllocationTracker.Counters measurementStart;
+
+    public override void _Ready()
+    {
+        OS.VsyncEnabled = false;
+        Engine.TargetFps = 0;
+
+        StartRun();
+    }
+
+    public override void _Process(float delta)
+    {
+        // The Godot physics server has stepped since the end of the last _PhysicsProcess
+        if (!stepStopwatch.IsRunning)
+            return;
+
+        stepStopwatch.Stop();
+        frameTimes.Add((float)stepStopwatch.Elapsed.TotalMilliseconds);
+    }
+
+    public override void _PhysicsProcess(float delta)
+    {
+        bool measuring = framesInRun >= WarmupFrames;
+
+        if (planarPhysics != null)
+        {
+            stepStopwatch.Restart();
+            planarPhysics.Step(delta);
+            stepStopwatch.Stop();
+
+            if (measuring)
+                frameTimes.Add((float)stepStopwatch.Elapsed.TotalMilliseconds);
+        }
+
+        ++framesInRun;
+
+        if (framesInRun <= WarmupFrames)
+        {
+            if (framesInRun == WarmupFrames)
+                measurementStart = AllocationTracker.Counters.Now();
+
+            return;
+        }
+
+        if (framesInRun < WarmupFrames + MeasuredFrames)
+        {
+            // Measured in _Process once the server has stepped
+            if (planarPhysics == null)
+                stepStopwatch.Restart();
+
+            return;
+        }
+
+        EndRun();
+
+        if (currentIsPlanar)
+        {
+            ++currentCountIndex;
+
+            if (currentCountIndex >= BodyCounts.Length)
+            {
+                WriteResults();
+                GetTree().Quit();
+                return;
+            }
+        }
+
+        currentIsPlanar = !currentIsPlanar;
+        StartRun();
+    }
+
+    private void StartRun()
+    {
+        // Same seed for both backends so they start from the same positions
+        random = new Random(BodyCounts[currentCountIndex]);
+
+        bodiesRoot = new Spatial();
+        AddChild(bodiesRoot);
+
+        if (currentIsPlanar)
+            planarPhysics = new PlanarPhysicsSystem(bodiesRoot);
+
+        int count = BodyCounts[currentCountIndex];
+        float halfSize = Mathf.Sqrt(count * AreaPerBody) * 0.5f;
+
+        var shape = new SphereShape { Radius = BodyRadius };
+
+        for (int i = 0; i < count; ++i)
+        {
+            var position = new Vector2(RandomRange(-halfSize, halfSize), RandomRange(-halfSize, halfSize));
+            var velocity = new Vector2(RandomRange(-5, 5), RandomRange(-5, 5));
+
+            if (currentIsPlanar)
+            {
+                var node = new Spatial();
+                bodiesRoot.AddChild(node);
+                planarPhysics.AddBody(node, position, velocity, BodyRadius, 1.0f, -1.0f);
+            }
+            else
+            {
+                var body = new RigidBody
+                {
+                    GravityScale = 0,
+                    AxisLockLinearY = true,
+                    AxisLockAngularX = true,
+                    AxisLockAngularZ = true,
+                    Translation = new Vector3(position.x, Constants.CLOUD_Y_COORDINATE, position.y),
+                    LinearVelocity = new Vector3(velocity.x, 0, velocity.y),
+                };
+
+                body.AddChild(new CollisionShape { Shape = shape });
+                bodiesRoot.AddChild(body);
+            }
+        }
+
+        framesInRun = 0;
+        frameTimes.Clear();
+        stepStopwatch.Reset();
+    }
+
+    private void EndRun()
+    {
+        var sorted = frameTimes.OrderBy(time => time).ToList();
+        var allocations = AllocationTracker.Counters.Now().Since(measurementStart);
+
+        results.Add(new RunResult
+        {
+            Backend = currentIsPlanar ? "planar" : "godot",
+            Bodies = BodyCounts[currentCountIndex],
+            ActiveContacts = planarPhysics?.ActiveContacts ?? -1,
+            AverageMilliseconds = sorted.Average(),
+            MedianMilliseconds = sorted[sorted.Count / 2],
+            MaxMilliseconds = sorted[sorted.Count - 1],
+            AllocatedBytesPerFrame = allocations.AllocatedBytes / sorted.Count,
+            Gen0Collections = allocations.Gen0Collections,
+            Gen1Collections = allocations.Gen1Collections,
+            Gen2Collections = allocations.Gen2Collections,
+        });
+
+        GD.Print($"Physics benchmark: {results.Last().Backend} with {results.Last().Bodies} bodies, " +
+            $"average: {results.Last().AverageMilliseconds} ms");
+
+        bodiesRoot.QueueFree();
+        bodiesRoot = null;
+        planarPhysics = null;
+    }
+
+    private void WriteResults()
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write benchmark results to: ", path);
+                return;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(results, Formatting.Indented));
+            file.Close();
+        }
+
+        GD.Print("Physics benchmark results written to: ", path);
+    }
+
+    private float RandomRange(float min, float max)
+    {
+        return (float)random.NextDouble() * (max - min) + min;
+    }
+
+    public class RunResult
+    {
+        public string Backend { get; set; }
+        public int Bodies { get; set; }
+
+        /// <summary>
+        ///   Contacts at the end of the run, -1 if the backend doesn't report this
+        /// </summary>
+        public int ActiveContacts { get; set; }
+
+        public float AverageMilliseconds { get; set; }
+        public float MedianMilliseconds { get; set; }
+        public float MaxMilliseconds { get; set; }
+
+        /// <summary>
+        ///   Managed allocations of the measured frames, including the executor tasks
+        /// </summary>
+        public long AllocatedBytesPerFrame { get; set; }
+
+        public int Gen0Collections { get; set; }
+        public int Gen1Collections { get; set; }
+        public int Gen2Collections { get; set; }
+    }
+}
@@ -0,0 +1,325 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Plays the microbe stage unattended for a long time to find leaks. Started with the --soak=minutes command
+///   line option, for example: godot --no-window -- --soak=240
+/// </summary>
+/// <remarks>
+///   <para>
+///     The player cell is driven by the same AI as the other cells, and the player goes to the editor at regular
+///     intervals so that auto-evo runs and the stage is reused. Memory use, object counts and the system timings
+///     are sampled while in the stage. When the time is up the samples are written to
+///     Constants.BENCHMARK_FOLDER along with the memory and object count metrics that kept growing, and the game
+///     quits with exit code 1 if any were found.
+///   </para>
+/// </remarks>
+public class SoakTest : Node
+{
+    private const string RESULT_FILE_NAME = "soak.json";
+
+    private readonly List<Sample> samples = new List<Sample>();
+
+    private readonly Random random = new Random();
+
+    private readonly SpeciesRelationships relationships = new SpeciesRelationships();
+
+    /// <summary>
+    ///   The lists and the data given to the player AI, reused so that driving the player doesn't add to the
+    ///   measured allocations
+    /// </summary>
+    private readonly List<Microbe> microbes = new List<Microbe>();
+
+    private readonly List<FloatingChunk> chunks = new List<FloatingChunk>();
+
+    private readonly float durationSeconds = CommandLineOptions.SoakMinutes * 60;
+
+    private ulong startTicks;
+
+    private Microbe drivenPlayer;
+    private MicrobeAI playerAI;
+    private MicrobeAICommonData playerAIData;
+    private float timeUntilPlayerThink;
+
+    private float stageTime;
+    private float timeUntilSample = Constants.SOAK_SAMPLE_INTERVAL;
+
+    private int editorCycles;
+    private int restarts;
+
+    /// <summary>
+    ///   Seconds since the soak test started, in real time
+    /// </summary>
+    public float Elapsed => (OS.GetTicksMsec() - startTicks) / 1000.0f;
+
+    /// <summary>
+    ///   Finds the memory and object count metrics that grew over the samples. A metric is growing if it rose by
+    ///   more than Constants.SOAK_GROWTH_THRESHOLD and a minimum amount, and barely ever went down. The timings
+    ///   and allocation rates aren't checked as they change with what happens in the game.
+    /// </summary>
+    /// <returns>The names of the growing metrics</returns>
+    public static List<string> FindGrowingMetrics(IList<Sample> samples)
+    {
+        var result = new List<string>();
+
+        // The first samples are skipped as caches and pools are still filling up
+        var considered = samples.Skip(Constants.SOAK_WARMUP_SAMPLES).ToList();
+
+        if (considered.Count < Constants.SOAK_MIN_TREND_SAMPLES)
+            return result;
+
+        FindGrowing(considered, sample => sample.MemoryBytes, Constants.SOAK_MIN_GROWTH_BYTES, result);
+        FindGrowing(considered, sample => sample.ObjectCounts, Constants.SOAK_MIN_GROWTH_COUNT, result);
+
+        return result;
+    }
+
+    public override void _Ready()
+    {
+        // Keep running even if something pauses the game
+        PauseMode = PauseModeEnum.Process;
+
+        startTicks = OS.GetTicksMsec();
+
+        GD.Print("Starting a soak test of ", durationSeconds / 60, " minutes");
+    }
+
+    public override void _Process(float delta)
+    {
+        switch (GetTree().CurrentScene)
+        {
+            case MicrobeStage stage:
+                DriveStage(stage, delta);
+                break;
+            case MicrobeEditor editor:
+                if (editor.EditorReady)
+                {
+                    ++editorCycles;
+                    GD.Print("Soak test: leaving editor cycle ", editorCycles);
+                    editor.OnFinishEditing();
+                }
+
+                break;
+        }
+
+        if (Elapsed >= durationSeconds)
+            Finish();
+    }
+
+    private static void FindGrowing(List<Sample> samples, Func<Sample, Dictionary<string, double>> metrics,
+        double minimumGrowth, List<string> result)
+    {
+        foreach (var metric in metrics(samples.Last()).Keys)
+        {
+            var values = samples.Select(sample =>
+                metrics(sample).TryGetValue(metric, out double value) ? value : 0).ToList();
+
+            int increasing = 0;
+
+            for (int i = 1; i < values.Count; ++i)
+            {
+                if (values[i] >= values[i - 1])
+                    ++increasing;
+            }
+
+            bool monotonic = increasing >= (values.Count - 1) * Constants.SOAK_MONOTONIC_FRACTION;
+
+            // The minimum is needed for the metrics that start from 0, for them any growth is infinitely large
+            double growth = values.Last() - values.First();
+            bool grew = growth > values.First() * Constants.SOAK_GROWTH_THRESHOLD && growth >= minimumGrowth;
+
+            if (monotonic && grew)
+                result.Add(metric);
+        }
+    }
+
+    private void DriveStage(MicrobeStage stage, float delta)
+    {
+        if (stage.GameOver)
+        {
+            ++restarts;
+            GD.Print("Soak test: player went extinct, starting a new game");
+            SceneManager.Instance.SwitchToScene(MainGameState.MicrobeStage);
+            return;
+        }
+
+        // The tutorial popups would pause the game, and the AI controls the player instead of the input
+        stage.TutorialState.Enabled = false;
+        GetTree().Paused = false;
+
+        var input = stage.GetNode("PlayerMicrobeInput");
+        input.SetProcess(false);
+        input.SetProcessUnhandledInput(false);
+
+        DrivePlayer(stage, delta);
+
+        stageTime += delta;
+        timeUntilSample -= delta;
+
+        if (timeUntilSample <= 0)
+        {
+            timeUntilSample = Constants.SOAK_SAMPLE_INTERVAL;
+            TakeSample();
+        }
+
+        if (stageTime >= Constants.SOAK_EDITOR_INTERVAL && stage.Player != null && !stage.Player.Dead)
+        {
+            stageTime = 0;
+            stage.MoveToEditor();
+        }
+    }
+
+    private void DrivePlayer(MicrobeStage stage, float delta)
+    {
+        var player = stage.Player;
+
+        if (player == null || player.Dead)
+            return;
+
+        if (player != drivenPlayer)
+        {
+            drivenPlayer = player;
+            playerAI = new MicrobeAI(player);
+        }
+
+        timeUntilPlayerThink -= delta;
+
+        if (timeUntilPlayerThink > 0)
+            return;
+
+        timeUntilPlayerThink = Constants.MICROBE_AI_THINK_INTERVAL;
+
+        var allMicrobes = GetTree().GetNodesInGroup(Constants.AI_TAG_MICROBE);
+        var allChunks = GetTree().GetNodesInGroup(Constants.AI_TAG_CHUNK);
+
+        microbes.Clear();
+        chunks.Clear();
+
+        for (int i = 0; i < allMicrobes.Count; ++i)
+            microbes.Add((Microbe)allMicrobes[i]);
+
+        for (int i = 0; i < allChunks.Count; ++i)
+            chunks.Add((FloatingChunk)allChunks[i]);
+
+        relationships.Build(microbes);
+
+        if (playerAIData == null)
+        {
+            playerAIData = new MicrobeAICommonData(microbes, chunks, relationships, stage.Clouds.GradientField);
+        }
+        else
+        {
+            playerAIData.Update(microbes, chunks, stage.Clouds.GradientField);
+        }
+
+        playerAI.Think(delta, random, playerAIData);
+
+        // The player is not in the AI group so MicrobeAISystem doesn't apply its actions, like shooting toxins
+        player.ApplyAIActions();
+    }
+
+    private void TakeSample()
+    {
+        var report = MemoryReport.Create(GetTree());
+
+        var sample = new Sample
+        {
+            Seconds = Elapsed,
+            EditorCycles = editorCycles,
+        };
+
+        sample.MemoryBytes["engine_static_bytes"] = report.EngineStaticBytes;
+        sample.MemoryBytes["engine_dynamic_bytes"] = report.EngineDynamicBytes;
+        sample.MemoryBytes["managed_heap_bytes"] = report.ManagedHeapBytes;
+        sample.MemoryBytes["texture_bytes"] = report.TextureBytes;
+        sample.ObjectCounts["objects"] = report.Objects;
+        sample.ObjectCounts["nodes"] = report.Nodes;
+        sample.ObjectCounts["orphan_nodes"] = report.OrphanNodes;
+
+        foreach (var entry in report.Entries)
+        {
+            var name = $"{entry.Subsystem}/{entry.Item}";
+            sample.ObjectCounts[name + " count"] = entry.Count;
+
+            if (entry.Bytes > 0)
+                sample.MemoryBytes[name + " bytes"] = entry.Bytes;
+        }
+
+        foreach (QualityGovernor.GovernedSystem system in Enum.GetValues(typeof(QualityGovernor.GovernedSystem)))
+        {
+            sample.Rates[$"{system} ms"] = QualityGovernor.Instance.GetSystemCost(system);
+            sample.Rates[$"{system} allocated bytes"] = AllocationTracker.Instance.GetSystemBytes(system);
+        }
+
+        samples.Add(sample);
+
+        GD.Print("Soak test sample at ", Mathf.RoundToInt(sample.Seconds), " s: nodes ", report.Nodes,
+            ", orphans ", report.OrphanNodes, ", managed heap ", report.ManagedHeapBytes);
+    }
+
+    private void Finish()
+    {
+        SetProcess(false);
+
+        var growing = FindGrowingMetrics(samples);
+
+        var result = new SoakResult
+        {
+            Seconds = Elapsed,
+            EditorCycles = editorCycles,
+            Restarts = restarts,
+            GrowingMetrics = growing,
+            Samples = samples,
+        };
+
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, RESULT_FILE_NAME);
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) == Error.Ok)
+            {
+                file.StoreString(JsonConvert.SerializeObject(result, Formatting.Indented));
+                file.Close();
+                GD.Print("Soak test results written to: ", path);
+            }
+            else
+            {
+                GD.PrintErr("Can't write soak test results to: ", path);
+            }
+        }
+
+        foreach (var metric in growing)
+            GD.PrintErr("Soak test: ", metric, " kept growing");
+
+        GD.Print("Soak test finished after ", editorCycles, " editor cycles, ", growing.Count,
+            " growing metrics");
+
+        GetTree().Quit(growing.Count > 0 ? 1 : 0);
+    }
+
+    public class Sample
+    {
+        public float Seconds { get; set; }
+        public int EditorCycles { get; set; }
+        public Dictionary<string, double> MemoryBytes { get; set; } = new Dictionary<string, double>();
+        public Dictionary<string, double> ObjectCounts { get; set; } = new Dictionary<string, double>();
+
+        /// <summary>
+        ///   Per frame values like the system timings, these are not checked for growth
+        /// </summary>
+        public Dictionary<string, double> Rates { get; set; } = new Dictionary<string, double>();
+    }
+
+    public class SoakResult
+    {
+        public float Seconds { get; set; }
+        public int EditorCycles { get; set; }
+        public int Restarts { get; set; }
+        public List<string> GrowingMetrics { get; set; }
+        public List<Sample> Samples { get; set; }
+    }
+}
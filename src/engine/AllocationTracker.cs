@@ -0,0 +1,258 @@
+using System;
+using System.Diagnostics;
+using System.Reflection;
+using System.Text;
+using Godot;
+
+/// <summary>
+///   Tracks the managed memory allocated by the stage systems and the garbage collections it causes
+/// </summary>
+/// <remarks>
+///   <para>
+///     The systems measure their allocations with BeginMeasure and EndMeasure, which include the allocations
+///     made by the TaskExecutor worker threads for the system. The runtime doesn't report how long collections
+///     pause the game, so the pause is estimated from how much longer a frame with a collection took than the
+///     frames without. The frames are timed with a stopwatch between the Update calls.
+///   </para>
+/// </remarks>
+public class AllocationTracker
+{
+    /// <summary>
+    ///   GC.GetAllocatedBytesForCurrentThread is provided by the Mono runtime but isn't in the net472 reference
+    ///   assemblies, so it is looked up at runtime
+    /// </summary>
+    private static readonly Func<long> ThreadAllocatedBytes = FindThreadAllocatedBytes();
+
+    // This needs to be after ThreadAllocatedBytes as the constructor uses it
+    private static readonly AllocationTracker SingletonInstance = new AllocationTracker();
+
+    private readonly long[] systemBytes = new long[Enum.GetValues(typeof(QualityGovernor.GovernedSystem)).Length];
+    private readonly float[] smoothedSystemBytes =
+        new float[Enum.GetValues(typeof(QualityGovernor.GovernedSystem)).Length];
+
+    /// <summary>
+    ///   Times the frames between the Update calls
+    /// </summary>
+    private readonly Stopwatch frameStopwatch = new Stopwatch();
+
+    private Counters frameStart;
+
+    private float smoothedFrameBytes;
+
+    /// <summary>
+    ///   Smoothed cost of the frames without a collection, used as the baseline for the pause estimate
+    /// </summary>
+    private float smoothedQuietFrameCost;
+
+    static AllocationTracker()
+    {
+    }
+
+    private AllocationTracker()
+    {
+        frameStart = Counters.Now();
+        frameStopwatch.Start();
+    }
+
+    public static AllocationTracker Instance => SingletonInstance;
+
+    /// <summary>
+    ///   False when the runtime can't report per thread allocations. The process wide heap size is then used
+    ///   instead, which is not accurate while other threads are allocating.
+    /// </summary>
+    public static bool IsPerThread => ThreadAllocatedBytes != null;
+
+    /// <summary>
+    ///   The allocations and collections of the last frame. The allocations include all the code on the main
+    ///   thread and the executor tasks.
+    /// </summary>
+    public Counters LastFrame { get; private set; }
+
+    /// <summary>
+    ///   Counts since the tracking was reset
+    /// </summary>
+    public Counters Total { get; private set; }
+
+    public int FramesWithCollections { get; private set; }
+
+    /// <summary>
+    ///   Estimated length of the last collection pause in milliseconds
+    /// </summary>
+    public float LastPauseEstimate { get; private set; }
+
+    public float MaxPauseEstimate { get; private set; }
+
+    /// <summary>
+    ///   Bytes allocated so far by the calling thread
+    /// </summary>
+    public static long CurrentThreadAllocatedBytes()
+    {
+        if (ThreadAllocatedBytes != null)
+            return ThreadAllocatedBytes();
+
+        return GC.GetTotalMemory(false);
+    }
+
+    /// <summary>
+    ///   Bytes allocated so far by the calling thread and the executor tasks it has run
+    /// </summary>
+    public static long AllocatedBytes()
+    {
+        return CurrentThreadAllocatedBytes() + TaskExecutor.Instance.WorkerAllocatedBytes;
+    }
+
+    /// <summary>
+    ///   Starts measuring a system update. Must be called on the main thread.
+    /// </summary>
+    /// <returns>The value to pass to EndMeasure</returns>
+    public long BeginMeasure()
+    {
+        return AllocatedBytes();
+    }
+
+    public void EndMeasure(QualityGovernor.GovernedSystem system, long start)
+    {
+        // The process wide fallback can go down when a collection happens
+        systemBytes[(int)system] += Math.Max(0, AllocatedBytes() - start);
+    }
+
+    public float GetSystemBytes(QualityGovernor.GovernedSystem system)
+    {
+        return smoothedSystemBytes[(int)system];
+    }
+
+    /// <summary>
+    ///   Finishes the measurements of the previous frame. Should be called once per frame by the active stage.
+    /// </summary>
+    public void Update()
+    {
+        var now = Counters.Now();
+        var frame = now.Since(frameStart);
+        frameStart = now;
+
+        LastFrame = frame;
+        Total = Total.Add(frame);
+
+        smoothedFrameBytes = Mathf.Lerp(smoothedFrameBytes, frame.AllocatedBytes,
+            Constants.QUALITY_GOVERNOR_SMOOTHING);
+
+        for (int i = 0; i < systemBytes.Length; ++i)
+        {
+            smoothedSystemBytes[i] = Mathf.Lerp(smoothedSystemBytes[i], systemBytes[i],
+                Constants.QUALITY_GOVERNOR_SMOOTHING);
+            systemBytes[i] = 0;
+        }
+
+        // Length of the frame the collections were counted in. The process time monitors can't be used as they
+        // are updated only once per second.
+        var frameCost = (float)frameStopwatch.Elapsed.TotalMilliseconds;
+        frameStopwatch.Restart();
+
+        if (frame.Collections > 0)
+        {
+            ++FramesWithCollections;
+            LastPauseEstimate = Math.Max(0, frameCost - smoothedQuietFrameCost);
+            MaxPauseEstimate = Math.Max(MaxPauseEstimate, LastPauseEstimate);
+        }
+        else
+        {
+            smoothedQuietFrameCost = Mathf.Lerp(smoothedQuietFrameCost, frameCost,
+                Constants.QUALITY_GOVERNOR_SMOOTHING);
+        }
+    }
+
+    /// <summary>
+    ///   Clears the totals, for example when a new benchmark run starts
+    /// </summary>
+    public void Reset()
+    {
+        frameStart = Counters.Now();
+        frameStopwatch.Restart();
+        Total = default;
+        FramesWithCollections = 0;
+        LastPauseEstimate = 0;
+        MaxPauseEstimate = 0;
+    }
+
+    public string GetStatusText()
+    {
+        var builder = new StringBuilder();
+
+        builder.AppendFormat("Allocated: {0:F1} KiB / frame{1}\n", smoothedFrameBytes / 1024,
+            IsPerThread ? string.Empty : " (heap size estimate)");
+
+        foreach (QualityGovernor.GovernedSystem system in Enum.GetValues(typeof(QualityGovernor.GovernedSystem)))
+        {
+            builder.AppendFormat("{0}: {1:F1} KiB\n", system, GetSystemBytes(system) / 1024);
+        }
+
+        builder.AppendFormat("GC gen 0/1/2: {0}/{1}/{2}, pause estimate last {3:F1} ms, max {4:F1} ms\n",
+            Total.Gen0Collections, Total.Gen1Collections, Total.Gen2Collections, LastPauseEstimate,
+            MaxPauseEstimate);
+
+        return builder.ToString();
+    }
+
+    private static Func<long> FindThreadAllocatedBytes()
+    {
+        var method = typeof(GC).GetMethod("GetAllocatedBytesForCurrentThread",
+            BindingFlags.Public | BindingFlags.Static, null, Type.EmptyTypes, null);
+
+        if (method == null)
+        {
+            GD.Print("Per thread allocation counts are not available, using the heap size instead");
+            return null;
+        }
+
+        return (Func<long>)Delegate.CreateDelegate(typeof(Func<long>), method);
+    }
+
+    /// <summary>
+    ///   Allocation and collection counts at some point, or between two points
+    /// </summary>
+    public struct Counters
+    {
+        public long AllocatedBytes;
+
+        // Collecting a generation also collects the younger ones, and they are all counted as a collection of
+        // each generation
+        public int Gen0Collections;
+        public int Gen1Collections;
+        public int Gen2Collections;
+
+        public int Collections => Gen0Collections;
+
+        public static Counters Now()
+        {
+            return new Counters
+            {
+                AllocatedBytes = AllocationTracker.AllocatedBytes(),
+                Gen0Collections = GC.CollectionCount(0),
+                Gen1Collections = GC.CollectionCount(1),
+                Gen2Collections = GC.CollectionCount(2),
+            };
+        }
+
+        public Counters Since(Counters start)
+        {
+            return new Counters
+            {
+                AllocatedBytes = Math.Max(0, AllocatedBytes - start.AllocatedBytes),
+                Gen0Collections = Gen0Collections - start.Gen0Collections,
+                Gen1Collections = Gen1Collections - start.Gen1Collections,
+                Gen2Collections = Gen2Collections - start.Gen2Collections,
+            };
+        }
+
+        public Counters Add(Counters other)
+        {
+            return new Counters
+            {
+                AllocatedBytes = AllocatedBytes + other.AllocatedBytes,
+                Gen0Collections = Gen0Collections + other.Gen0Collections,
+                Gen1Collections = Gen1Collections + other.Gen1Collections,
+                Gen2Collections = Gen2Collections + other.Gen2Collections,
+            };
+        }
+    }
+}
@@ -0,0 +1,87 @@
+using System;
+using System.Globalization;
+using Godot;
+
+/// <summary>
+///   Thrive specific command line options. These are given after "--" so that Godot ignores them,
+///   for example: godot -- --record-input=user://recording.input
+/// </summary>
+public static class CommandLineOptions
+{
+    private const string RECORD_INPUT = "--record-input=";
+    private const string REPLAY_INPUT = "--replay-input=";
+    private const string SOAK = "--soak=";
+    private const string METRICS_FILE = "--metrics-file=";
+    private const string NO_JIT_WARMUP = "--no-jit-warmup";
+    private const string SAFE_CLOUD_KERNELS = "--safe-cloud-kernels";
+
+    static CommandLineOptions()
+    {
+        foreach (var argument in OS.GetCmdlineArgs())
+        {
+            if (argument.StartsWith(RECORD_INPUT, StringComparison.Ordinal))
+            {
+                RecordInputPath = argument.Substring(RECORD_INPUT.Length);
+            }
+            else if (argument.StartsWith(REPLAY_INPUT, StringComparison.Ordinal))
+            {
+                ReplayInputPath = argument.Substring(REPLAY_INPUT.Length);
+            }
+            else if (argument.StartsWith(METRICS_FILE, StringComparison.Ordinal))
+            {
+                MetricsFilePath = argument.Substring(METRICS_FILE.Length);
+            }
+            else if (argument == NO_JIT_WARMUP)
+            {
+                NoJitWarmup = true;
+            }
+            else if (argument == SAFE_CLOUD_KERNELS)
+            {
+                SafeCloudKernels = true;
+            }
+            else if (argument.StartsWith(SOAK, StringComparison.Ordinal))
+            {
+                if (float.TryParse(argument.Substring(SOAK.Length), NumberStyles.Float,
+                    CultureInfo.InvariantCulture, out float minutes))
+                {
+                    SoakMinutes = minutes;
+                }
+                else
+                {
+                    GD.PrintErr("Invalid soak duration: ", argument);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    ///   If set the player input of new microbe stage games is recorded to this file
+    /// </summary>
+    public static string RecordInputPath { get; }
+
+    /// <summary>
+    ///   If set the game starts directly in the microbe stage replaying the input recording from this file,
+    ///   and quits when the replay ends
+    /// </summary>
+    public static string ReplayInputPath { get; }
+
+    /// <summary>
+    ///   If above 0 the game runs a soak test for this many minutes, see SoakTest
+    /// </summary>
+    public static float SoakMinutes { get; }
+
+    /// <summary>
+    ///   If set performance counters are periodically written to this file, see MetricsExporter
+    /// </summary>
+    public static string MetricsFilePath { get; }
+
+    /// <summary>
+    ///   If true the JitWarmup is not done, for measuring its effect
+    /// </summary>
+    public static bool NoJitWarmup { get; }
+
+    /// <summary>
+    ///   If true the clouds use the bounds checked versions of the CloudKernels
+    /// </summary>
+    public static bool SafeCloudKernels { get; }
+}
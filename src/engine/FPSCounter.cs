@@ -1,20 +1,37 @@
 using Godot;
 
 /// <summary>
-///   Shows FPS at top left of the screen
-///   Toggled with F3
+///   Shows FPS at top left of the screen, along with the draw calls, quality governor decisions, task
+///   statistics, allocations and memory use
+///   Toggled with F3, F4 writes a memory report to a file
 /// </summary>
 public class FPSCounter : Control
 {
     private Label label;
+    private ColorRect background;
+
+    private string memorySummary = string.Empty;
+    private float timeSinceMemoryReport = float.MaxValue;
 
     public override void _Ready()
     {
         label = GetNode<Label>("Label");
+        background = GetNode<ColorRect>("ColorRect");
     }
 
     public override void _Input(InputEvent @event)
     {
+        if (@event.IsActionPressed("memory_report"))
+        {
+            var report = MemoryReport.Create(GetTree());
+            var path = report.Save();
+
+            if (path != null)
+                GD.Print("Memory report written to: ", path);
+
+            GD.Print(report.GetSummaryText());
+        }
+
         if (@event.IsActionPressed("toggle_FPS"))
         {
             if (Visible)
@@ -30,7 +47,26 @@ public class FPSCounter : Control
 
     public override void _Process(float delta)
     {
-        if (Visible)
-            label.Text = $"FPS: {Engine.GetFramesPerSecond()}";
+        if (!Visible)
+            return;
+
+        // Counting the nodes is too slow to do every frame
+        timeSinceMemoryReport += delta;
+
+        if (timeSinceMemoryReport > Constants.MEMORY_REPORT_INTERVAL)
+        {
+            timeSinceMemoryReport = 0;
+            memorySummary = MemoryReport.Create(GetTree()).GetSummaryText();
+        }
+
+        label.Text = $"FPS: {Engine.GetFramesPerSecond()}\n" +
+            $"Draw calls: {Performance.GetMonitor(Performance.Monitor.RenderDrawCallsInFrame)}, " +
+            $"material changes: {Performance.GetMonitor(Performance.Monitor.RenderMaterialChangesInFrame)}\n" +
+            QualityGovernor.Instance.GetStatusText() +
+            AllocationTracker.Instance.GetStatusText() + memorySummary;
+
+        // The label grows to fit the text, shrink it back to the minimum size in case the text got shorter
+        label.RectSize = Vector2.Zero;
+        background.RectSize = label.RectSize;
     }
 }
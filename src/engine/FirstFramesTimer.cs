@@ -0,0 +1,46 @@
+using System;
+using Godot;
+
+/// <summary>
+///   Measures the first frames after a scene is entered and prints how long they took. Used to see the effect of
+///   the JIT warm-up, the frames in the first seconds are where methods get compiled on first use.
+/// </summary>
+public class FirstFramesTimer
+{
+    private readonly string name;
+
+    private int frames;
+    private float totalTime;
+    private float worstTime;
+
+    public FirstFramesTimer(string name)
+    {
+        this.name = name;
+    }
+
+    /// <summary>
+    ///   Starts the measurement again, for example when the scene is reused
+    /// </summary>
+    public void Restart()
+    {
+        frames = 0;
+        totalTime = 0;
+        worstTime = 0;
+    }
+
+    public void Frame(float delta)
+    {
+        if (frames >= Constants.FIRST_FRAMES_MEASURED)
+            return;
+
+        ++frames;
+        totalTime += delta;
+        worstTime = Math.Max(worstTime, delta);
+
+        if (frames < Constants.FIRST_FRAMES_MEASURED)
+            return;
+
+        GD.Print(name, " first ", frames, " frames took ", Mathf.RoundToInt(totalTime * 1000), " ms, the worst ",
+            Mathf.RoundToInt(worstTime * 1000), " ms (", JitWarmup.GetStatusText(), ")");
+    }
+}
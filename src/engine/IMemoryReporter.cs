@@ -0,0 +1,10 @@
+/// <summary>
+///   Something that can tell how much memory it owns, for MemoryReport
+/// </summary>
+public interface IMemoryReporter
+{
+    /// <summary>
+    ///   Adds the memory owned by this, and the reporters this owns, to the report
+    /// </summary>
+    void ReportMemory(MemoryReport report);
+}
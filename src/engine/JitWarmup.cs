@@ -0,0 +1,184 @@
+using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Threading;
+using Godot;
+using Newtonsoft.Json;
+using Thread = System.Threading.Thread;
+
+/// <summary>
+///   Compiles the hot code of the stages ahead of time on a background thread so that the first frames of
+///   gameplay don't stutter while the runtime compiles methods as they are first called
+/// </summary>
+/// <remarks>
+///   <para>
+///     The warm-up is started when the game starts, so it is normally done before the main menu is left, and
+///     otherwise it keeps running while the loading screen is shown. It runs on its own low priority thread so
+///     that it doesn't take a TaskExecutor thread from the stage loading and doesn't slow down the main thread.
+///     It can be disabled with the --no-jit-warmup command line option to compare the first frame times
+///     reported by FirstFramesTimer, which also reports how much the warm-up did.
+///   </para>
+/// </remarks>
+public static class JitWarmup
+{
+    /// <summary>
+    ///   The types whose methods are compiled, including their nested types for lambdas and iterators
+    /// </summary>
+    private static readonly Type[] HotTypes =
+    {
+        typeof(ProcessSystem),
+        typeof(MicrobeAI),
+        typeof(MicrobeAISystem),
+        typeof(SpeciesRelationships),
+        typeof(CompoundCloudPlane),
+        typeof(CompoundCloudSystem),
+        typeof(CloudKernels),
+        typeof(CloudStamp),
+        typeof(CompoundGradientField),
+        typeof(Membrane),
+        typeof(Microbe),
+        typeof(MicrobeVisualDetailSystem),
+        typeof(CompoundBag),
+        typeof(SpawnSystem),
+        typeof(SimulationTierSystem),
+        typeof(PlanarPhysicsSystem),
+        typeof(FluidSystem),
+        typeof(ThriveJsonConverter),
+    };
+
+    private static int started;
+    private static volatile bool finished;
+
+    public static bool Finished => finished;
+
+    /// <summary>
+    ///   Number of methods compiled by the warm-up, valid once Finished
+    /// </summary>
+    public static int PreparedMethods { get; private set; }
+
+    /// <summary>
+    ///   How long the warm-up took, valid once Finished
+    /// </summary>
+    public static long Milliseconds { get; private set; }
+
+    /// <summary>
+    ///   Starts the warm-up on a background thread. Does nothing if already started.
+    /// </summary>
+    public static void Start()
+    {
+        if (CommandLineOptions.NoJitWarmup)
+        {
+            GD.Print("JIT warm-up is disabled");
+            return;
+        }
+
+        if (Interlocked.Exchange(ref started, 1) != 0)
+            return;
+
+        var thread = new Thread(Run)
+        {
+            IsBackground = true,
+            Name = "JitWarmup",
+            Priority = ThreadPriority.BelowNormal,
+        };
+
+        thread.Start();
+    }
+
+    /// <summary>
+    ///   Text for the first frame time report
+    /// </summary>
+    public static string GetStatusText()
+    {
+        if (CommandLineOptions.NoJitWarmup)
+            return "JIT warm-up disabled";
+
+        if (!Finished)
+            return "JIT warm-up not finished";
+
+        return $"JIT warm-up compiled {PreparedMethods} methods in {Milliseconds} ms";
+    }
+
+    private static void Run()
+    {
+        var stopwatch = Stopwatch.StartNew();
+
+        // The save converters are found through the JsonConverter base so that new ones are included
+        var converters = typeof(JitWarmup).Assembly.GetTypes().Where(type =>
+            typeof(JsonConverter).IsAssignableFrom(type));
+
+        PreparedMethods = HotTypes.Concat(converters).Distinct().Sum(PrepareType);
+
+        RunJsonRoundTrip();
+
+        Milliseconds = stopwatch.ElapsedMilliseconds;
+
+        // Set last so that the results are visible when this is seen as true
+        finished = true;
+
+        GD.Print(GetStatusText());
+    }
+
+    private static int PrepareType(Type type)
+    {
+        // Methods of open generic types can't be compiled without knowing the type arguments
+        if (type.ContainsGenericParameters)
+            return 0;
+
+        int count = 0;
+
+        foreach (var method in type.GetMethods(BindingFlags.DeclaredOnly | BindingFlags.Public |
+            BindingFlags.NonPublic | BindingFlags.Instance | BindingFlags.Static))
+        {
+            if (method.IsAbstract || method.ContainsGenericParameters)
+                continue;
+
+            if (Prepare(method.MethodHandle))
+                ++count;
+        }
+
+        foreach (var constructor in type.GetConstructors(BindingFlags.Public | BindingFlags.NonPublic |
+            BindingFlags.Instance))
+        {
+            if (Prepare(constructor.MethodHandle))
+                ++count;
+        }
+
+        return count + type.GetNestedTypes(BindingFlags.Public | BindingFlags.NonPublic).Sum(PrepareType);
+    }
+
+    private static bool Prepare(RuntimeMethodHandle handle)
+    {
+        try
+        {
+            RuntimeHelpers.PrepareMethod(handle);
+            return true;
+        }
+#pragma warning disable CA1031 // a method that can't be compiled early is just compiled when called
+        catch (Exception)
+#pragma warning restore CA1031
+        {
+            return false;
+        }
+    }
+
+    /// <summary>
+    ///   The serializer builds its contracts on first use, so a tiny object is saved and loaded to get that done
+    /// </summary>
+    private static void RunJsonRoundTrip()
+    {
+        try
+        {
+            var json = ThriveJsonConverter.Instance.SerializeObject(new CompoundBag(1.0f));
+            ThriveJsonConverter.Instance.DeserializeObject<CompoundBag>(json);
+        }
+#pragma warning disable CA1031 // the warm-up must never break the game
+        catch (Exception e)
+#pragma warning restore CA1031
+        {
+            GD.PrintErr("JIT warm-up JSON round trip failed: ", e.Message);
+        }
+    }
+}
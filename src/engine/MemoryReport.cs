@@ -0,0 +1,189 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Text;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   How much memory the engine and the game subsystems use
+/// </summary>
+/// <remarks>
+///   <para>
+///     The subsystems implementing IMemoryReporter add entries for the memory they own. Array and texture sizes
+///     are exact, while the size of object graphs like the species can only be described by their counts.
+///   </para>
+/// </remarks>
+public class MemoryReport
+{
+    public DateTime Time { get; set; } = DateTime.Now;
+
+    /// <summary>
+    ///   Memory allocated by the engine, including the textures and meshes, from OS.GetStaticMemoryUsage
+    /// </summary>
+    public ulong EngineStaticBytes { get; set; }
+
+    public ulong EngineDynamicBytes { get; set; }
+
+    public long ManagedHeapBytes { get; set; }
+
+    public long TextureBytes { get; set; }
+
+    public long VertexBytes { get; set; }
+
+    public int Objects { get; set; }
+
+    public int Nodes { get; set; }
+
+    /// <summary>
+    ///   Nodes not in the scene tree. A growing count points to a leak.
+    /// </summary>
+    public int OrphanNodes { get; set; }
+
+    public List<Entry> Entries { get; set; } = new List<Entry>();
+
+    /// <summary>
+    ///   When false the reporters don't count the nodes of each entity, as that walks all the entity node trees
+    /// </summary>
+    [JsonIgnore]
+    public bool IncludeNodeCounts { get; set; } = true;
+
+    /// <summary>
+    ///   Sum of the bytes of the entries
+    /// </summary>
+    [JsonIgnore]
+    public long TrackedBytes => Entries.Sum(entry => entry.Bytes);
+
+    /// <summary>
+    ///   Creates a report of the current scene
+    /// </summary>
+    /// <param name="tree">The tree to report</param>
+    /// <param name="includeNodeCounts">If false the per entity node counts are skipped to make this faster</param>
+    public static MemoryReport Create(SceneTree tree, bool includeNodeCounts = true)
+    {
+        var report = new MemoryReport
+        {
+            IncludeNodeCounts = includeNodeCounts,
+            EngineStaticBytes = OS.GetStaticMemoryUsage(),
+            EngineDynamicBytes = OS.GetDynamicMemoryUsage(),
+            ManagedHeapBytes = GC.GetTotalMemory(false),
+            TextureBytes = (long)Performance.GetMonitor(Performance.Monitor.RenderTextureMemUsed),
+            VertexBytes = (long)Performance.GetMonitor(Performance.Monitor.RenderVertexMemUsed),
+            Objects = (int)Performance.GetMonitor(Performance.Monitor.ObjectCount),
+            Nodes = (int)Performance.GetMonitor(Performance.Monitor.ObjectNodeCount),
+            OrphanNodes = (int)Performance.GetMonitor(Performance.Monitor.ObjectOrphanNodeCount),
+        };
+
+        if (tree.CurrentScene is IMemoryReporter reporter)
+            reporter.ReportMemory(report);
+
+        return report;
+    }
+
+    /// <summary>
+    ///   Number of nodes in a subtree, including the root
+    /// </summary>
+    public static int CountNodes(Node root)
+    {
+        int count = 1;
+
+        foreach (Node child in root.GetChildren())
+            count += CountNodes(child);
+
+        return count;
+    }
+
+    /// <summary>
+    ///   Adds an entry, or adds to an existing one with the same subsystem and item
+    /// </summary>
+    /// <param name="subsystem">The owning subsystem, for example "Clouds"</param>
+    /// <param name="item">What the memory is used for</param>
+    /// <param name="bytes">Owned bytes, 0 if only the count is known</param>
+    /// <param name="count">How many of the item there are</param>
+    public void Add(string subsystem, string item, long bytes, int count = 1)
+    {
+        var existing = Entries.FirstOrDefault(entry => entry.Subsystem == subsystem && entry.Item == item);
+
+        if (existing != null)
+        {
+            existing.Bytes += bytes;
+            existing.Count += count;
+            return;
+        }
+
+        Entries.Add(new Entry { Subsystem = subsystem, Item = item, Bytes = bytes, Count = count });
+    }
+
+    public long GetSubsystemBytes(string subsystem)
+    {
+        return Entries.Where(entry => entry.Subsystem == subsystem).Sum(entry => entry.Bytes);
+    }
+
+    /// <summary>
+    ///   Writes this report as JSON into Constants.BENCHMARK_FOLDER
+    /// </summary>
+    /// <returns>The path of the file, null on failure</returns>
+    public string Save()
+    {
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER,
+            "memory_" + Time.ToString("yyyy-MM-dd_HH.mm.ss", CultureInfo.InvariantCulture) + ".json");
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write memory report to: ", path);
+                return null;
+            }
+
+            file.StoreString(JsonConvert.SerializeObject(this, Formatting.Indented));
+            file.Close();
+        }
+
+        return path;
+    }
+
+    /// <summary>
+    ///   A short summary of the report, the subsystems are listed by the bytes they own
+    /// </summary>
+    public string GetSummaryText()
+    {
+        var builder = new StringBuilder();
+
+        builder.AppendFormat("Memory: engine {0}, managed {1}, textures {2}, nodes {3} ({4} orphan)\n",
+            FormatBytes((long)(EngineStaticBytes + EngineDynamicBytes)), FormatBytes(ManagedHeapBytes),
+            FormatBytes(TextureBytes), Nodes, OrphanNodes);
+
+        foreach (var group in Entries.GroupBy(entry => entry.Subsystem)
+            .OrderByDescending(group => group.Sum(entry => entry.Bytes)))
+        {
+            builder.AppendFormat("{0}: {1}", group.Key, FormatBytes(group.Sum(entry => entry.Bytes)));
+
+            foreach (var entry in group)
+                builder.AppendFormat(", {0} {1}", entry.Count, entry.Item);
+
+            builder.Append('\n');
+        }
+
+        return builder.ToString();
+    }
+
+    private static string FormatBytes(long bytes)
+    {
+        if (bytes >= 1024 * 1024)
+            return $"{bytes / (1024.0f * 1024.0f):F1} MiB";
+
+        return $"{bytes / 1024.0f:F1} KiB";
+    }
+
+    public class Entry
+    {
+        public string Subsystem { get; set; }
+        public string Item { get; set; }
+        public long Bytes { get; set; }
+        public int Count { get; set; }
+    }
+}
@@ -0,0 +1,363 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Text;
+using Godot;
+
+/// <summary>
+///   Writes performance counters periodically to a file in the Prometheus text exposition format, so that long
+///   running instances can be scraped (for example with the node exporter textfile collector). Enabled with the
+///   --metrics-file=path command line option.
+/// </summary>
+/// <remarks>
+///   <para>
+///     Each export is spread over several frames so that it doesn't cause a hitch: the cloud planes are counted
+///     one per frame and the rest is written on the frame after them. The memory report is made without the per
+///     entity node counts, the total node counts come from the engine.
+///   </para>
+/// </remarks>
+public class MetricsExporter : Node
+{
+    private static MetricsExporter instance;
+
+    private readonly List<float> frameTimes = new List<float>();
+
+    private readonly StringBuilder builder = new StringBuilder();
+
+    private float timeUntilExport = Constants.METRICS_EXPORT_INTERVAL;
+
+    private float lastSaveSeconds = -1;
+    private float lastLoadSeconds = -1;
+
+    /// <summary>
+    ///   Totals of all the frames since the start, Prometheus needs the summary sum and count to only increase
+    /// </summary>
+    private double totalFrameMilliseconds;
+
+    private long totalFrames;
+
+    /// <summary>
+    ///   Which part of the export is done on the next frame, -1 when not exporting
+    /// </summary>
+    private int exportStep = -1;
+
+    /// <summary>
+    ///   The stage the current export is for, null if not in the stage
+    /// </summary>
+    private MicrobeStage exportedStage;
+
+    private int activeCloudCells;
+
+    private MetricsExporter()
+    {
+        instance = this;
+    }
+
+    public static MetricsExporter Instance => instance;
+
+    public override void _Ready()
+    {
+        // Keep exporting while paused
+        PauseMode = PauseModeEnum.Process;
+
+        SetProcess(CommandLineOptions.MetricsFilePath != null);
+
+        if (CommandLineOptions.MetricsFilePath != null)
+            GD.Print("Exporting metrics to: ", CommandLineOptions.MetricsFilePath);
+    }
+
+    public override void _Process(float delta)
+    {
+        frameTimes.Add(delta * 1000.0f);
+
+        if (exportStep >= 0)
+        {
+            ContinueExport();
+            return;
+        }
+
+        timeUntilExport -= delta;
+
+        if (timeUntilExport > 0)
+            return;
+
+        timeUntilExport = Constants.METRICS_EXPORT_INTERVAL;
+
+        StartExport();
+    }
+
+    public void ReportSaveDuration(TimeSpan duration)
+    {
+        lastSaveSeconds = (float)duration.TotalSeconds;
+    }
+
+    public void ReportLoadDuration(TimeSpan duration)
+    {
+        lastLoadSeconds = (float)duration.TotalSeconds;
+    }
+
+    private static string FormatValue(double value)
+    {
+        if (double.IsNaN(value))
+            return "NaN";
+
+        if (double.IsPositiveInfinity(value))
+            return "+Inf";
+
+        if (double.IsNegativeInfinity(value))
+            return "-Inf";
+
+        return value.ToString(CultureInfo.InvariantCulture);
+    }
+
+    private static string EntryLabels(MemoryReport.Entry entry)
+    {
+        return $"subsystem=\"{EscapeLabel(entry.Subsystem)}\",item=\"{EscapeLabel(entry.Item)}\"";
+    }
+
+    private static string EscapeLabel(string value)
+    {
+        return value.Replace("\\", "\\\\").Replace("\"", "\\\"").Replace("\n", "\\n");
+    }
+
+    /// <summary>
+    ///   Writes the metrics that are quick to get and sets up the rest of the export
+    /// </summary>
+    private void StartExport()
+    {
+        builder.Clear();
+
+        WriteFrameTimes();
+        frameTimes.Clear();
+
+        WriteRendering();
+        WriteSystems();
+
+        exportedStage = GetTree().CurrentScene as MicrobeStage;
+
+        if (exportedStage?.CurrentGame == null)
+            exportedStage = null;
+
+        activeCloudCells = 0;
+        exportStep = 0;
+    }
+
+    /// <summary>
+    ///   Counts the next cloud plane, or when they are all counted writes the rest of the metrics and the file
+    /// </summary>
+    private void ContinueExport()
+    {
+        // The stage may have been left during the export
+        if (exportedStage != null && GetTree().CurrentScene != exportedStage)
+            exportedStage = null;
+
+        if (exportedStage != null && exportStep < exportedStage.Clouds.CloudPlaneCount)
+        {
+            activeCloudCells += exportedStage.Clouds.CountActiveCells(exportStep);
+            ++exportStep;
+            return;
+        }
+
+        if (exportedStage != null)
+            WriteStage(exportedStage);
+
+        WriteMemory();
+
+        if (lastSaveSeconds >= 0)
+        {
+            WriteHeader("thrive_last_save_seconds", "gauge", "Duration of the last save");
+            WriteSample("thrive_last_save_seconds", null, lastSaveSeconds);
+        }
+
+        if (lastLoadSeconds >= 0)
+        {
+            WriteHeader("thrive_last_load_seconds", "gauge", "Duration of the last save load");
+            WriteSample("thrive_last_load_seconds", null, lastLoadSeconds);
+        }
+
+        WriteFile(CommandLineOptions.MetricsFilePath, builder.ToString());
+
+        exportStep = -1;
+        exportedStage = null;
+    }
+
+    private void WriteFrameTimes()
+    {
+        foreach (var time in frameTimes)
+            totalFrameMilliseconds += time;
+
+        totalFrames += frameTimes.Count;
+
+        WriteHeader("thrive_frame_time_milliseconds", "summary",
+            "Frame time quantiles since the previous export, the sum and count are since the start");
+
+        if (frameTimes.Count > 0)
+        {
+            var sorted = frameTimes.OrderBy(time => time).ToList();
+
+            foreach (var quantile in new[] { 0.5f, 0.95f, 0.99f })
+            {
+                WriteSample("thrive_frame_time_milliseconds",
+                    $"quantile=\"{FormatValue(quantile)}\"",
+                    sorted[Math.Min(sorted.Count - 1, (int)(sorted.Count * quantile))]);
+            }
+        }
+
+        WriteSample("thrive_frame_time_milliseconds_sum", null, totalFrameMilliseconds);
+        WriteSample("thrive_frame_time_milliseconds_count", null, totalFrames);
+    }
+
+    private void WriteRendering()
+    {
+        WriteHeader("thrive_render_draw_calls", "gauge", "Draw calls in the last frame");
+        WriteSample("thrive_render_draw_calls", null,
+            Performance.GetMonitor(Performance.Monitor.RenderDrawCallsInFrame));
+
+        WriteHeader("thrive_render_material_changes", "gauge", "Material changes in the last frame");
+        WriteSample("thrive_render_material_changes", null,
+            Performance.GetMonitor(Performance.Monitor.RenderMaterialChangesInFrame));
+
+        WriteHeader("thrive_membrane_materials", "gauge", "Shared membrane materials, one per membrane type in use");
+        WriteSample("thrive_membrane_materials", null, MembraneMaterials.Count);
+    }
+
+    private void WriteSystems()
+    {
+        var systems = (QualityGovernor.GovernedSystem[])Enum.GetValues(typeof(QualityGovernor.GovernedSystem));
+
+        WriteHeader("thrive_system_time_milliseconds", "gauge", "Smoothed time the stage systems take per frame");
+
+        foreach (var system in systems)
+        {
+            WriteSample("thrive_system_time_milliseconds", $"system=\"{system}\"",
+                QualityGovernor.Instance.GetSystemCost(system));
+        }
+
+        WriteHeader("thrive_system_allocated_bytes", "gauge",
+            "Smoothed managed bytes the stage systems allocate per frame");
+
+        foreach (var system in systems)
+        {
+            WriteSample("thrive_system_allocated_bytes", $"system=\"{system}\"",
+                AllocationTracker.Instance.GetSystemBytes(system));
+        }
+
+        var allocations = AllocationTracker.Instance.Total;
+
+        WriteHeader("thrive_gc_collections_total", "counter", "Garbage collections while in the stage");
+        WriteSample("thrive_gc_collections_total", "generation=\"0\"", allocations.Gen0Collections);
+        WriteSample("thrive_gc_collections_total", "generation=\"1\"", allocations.Gen1Collections);
+        WriteSample("thrive_gc_collections_total", "generation=\"2\"", allocations.Gen2Collections);
+
+        WriteHeader("thrive_allocated_bytes_total", "counter", "Managed bytes allocated while in the stage");
+        WriteSample("thrive_allocated_bytes_total", null, allocations.AllocatedBytes);
+
+        WriteHeader("thrive_gc_pause_estimate_max_milliseconds", "gauge",
+            "Longest estimated garbage collection pause");
+        WriteSample("thrive_gc_pause_estimate_max_milliseconds", null, AllocationTracker.Instance.MaxPauseEstimate);
+    }
+
+    private void WriteStage(MicrobeStage stage)
+    {
+        WriteHeader("thrive_spawned_entities", "gauge", "Spawned entity estimate and the current limit");
+        WriteSample("thrive_spawned_entities", "kind=\"estimate\"", stage.Spawner.EntityEstimate);
+        WriteSample("thrive_spawned_entities", "kind=\"limit\"", stage.Spawner.EntityLimit);
+
+        WriteHeader("thrive_simulation_tier_entities", "gauge", "Spawned entities in each simulation tier");
+        WriteSample("thrive_simulation_tier_entities", "tier=\"near\"", stage.SimulationTiers.NearCount);
+        WriteSample("thrive_simulation_tier_entities", "tier=\"mid\"", stage.SimulationTiers.MidCount);
+        WriteSample("thrive_simulation_tier_entities", "tier=\"far\"", stage.SimulationTiers.FarCount);
+
+        WriteHeader("thrive_microbe_visual_detail", "gauge", "Microbes drawn at each visual detail level");
+        WriteSample("thrive_microbe_visual_detail", "level=\"full\"", stage.VisualDetail.FullCount);
+        WriteSample("thrive_microbe_visual_detail", "level=\"reduced\"", stage.VisualDetail.ReducedCount);
+        WriteSample("thrive_microbe_visual_detail", "level=\"impostor\"", stage.VisualDetail.ImpostorCount);
+
+        WriteHeader("thrive_cloud_cells_active", "gauge", "Compound cloud cells containing compounds");
+        WriteSample("thrive_cloud_cells_active", null, activeCloudCells);
+
+        var autoEvo = stage.GameWorld.GetAutoEvoRunIfStarted();
+
+        if (autoEvo != null)
+        {
+            WriteHeader("thrive_auto_evo_completion_ratio", "gauge", "Progress of the current auto-evo run");
+            WriteSample("thrive_auto_evo_completion_ratio", null, autoEvo.Finished ? 1 : autoEvo.CompletionFraction);
+        }
+    }
+
+    private void WriteMemory()
+    {
+        var report = MemoryReport.Create(GetTree(), false);
+
+        WriteHeader("thrive_engine_memory_bytes", "gauge", "Memory allocated by the engine");
+        WriteSample("thrive_engine_memory_bytes", "kind=\"static\"", report.EngineStaticBytes);
+        WriteSample("thrive_engine_memory_bytes", "kind=\"dynamic\"", report.EngineDynamicBytes);
+        WriteSample("thrive_engine_memory_bytes", "kind=\"texture\"", report.TextureBytes);
+        WriteSample("thrive_engine_memory_bytes", "kind=\"vertex\"", report.VertexBytes);
+
+        WriteHeader("thrive_managed_heap_bytes", "gauge", "Size of the managed heap");
+        WriteSample("thrive_managed_heap_bytes", null, report.ManagedHeapBytes);
+
+        WriteHeader("thrive_nodes", "gauge", "Engine node counts");
+        WriteSample("thrive_nodes", "kind=\"all\"", report.Nodes);
+        WriteSample("thrive_nodes", "kind=\"orphan\"", report.OrphanNodes);
+
+        // Entity counts by type are in here, as the "Entities" subsystem
+        WriteHeader("thrive_subsystem_items", "gauge", "Items owned by the game subsystems, from the memory report");
+
+        foreach (var entry in report.Entries)
+        {
+            WriteSample("thrive_subsystem_items", EntryLabels(entry), entry.Count);
+        }
+
+        WriteHeader("thrive_subsystem_bytes", "gauge", "Bytes owned by the game subsystems, from the memory report");
+
+        foreach (var entry in report.Entries.Where(entry => entry.Bytes > 0))
+        {
+            WriteSample("thrive_subsystem_bytes", EntryLabels(entry), entry.Bytes);
+        }
+    }
+
+    private void WriteHeader(string name, string type, string help)
+    {
+        builder.Append("# HELP ").Append(name).Append(' ').Append(help).Append('\n');
+        builder.Append("# TYPE ").Append(name).Append(' ').Append(type).Append('\n');
+    }
+
+    private void WriteSample(string name, string labels, double value)
+    {
+        builder.Append(name);
+
+        if (labels != null)
+            builder.Append('{').Append(labels).Append('}');
+
+        builder.Append(' ').Append(FormatValue(value)).Append('\n');
+    }
+
+    /// <summary>
+    ///   Writes to a temporary file first and then renames it, so that a scraper never sees a partial file
+    /// </summary>
+    private void WriteFile(string path, string content)
+    {
+        var temporary = path + ".tmp";
+
+        using (var file = new File())
+        {
+            if (file.Open(temporary, File.ModeFlags.Write) != Error.Ok)
+            {
+                GD.PrintErr("Can't write metrics to: ", temporary);
+                return;
+            }
+
+            file.StoreString(content);
+            file.Close();
+        }
+
+        using (var directory = new Directory())
+        {
+            if (directory.Rename(temporary, path) != Error.Ok)
+                GD.PrintErr("Can't move the metrics file to: ", path);
+        }
+    }
+}
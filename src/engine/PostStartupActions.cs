@@ -9,5 +9,8 @@ public class PostStartupActions : Node
     {
         // Queue window title set as setting it in the autoloads doesn't work yet
         Invoke.Instance.Perform(() => { OS.SetWindowTitle("Thrive - " + Constants.Version); });
+
+        // Compile the stage code in the background while the menu is shown
+        JitWarmup.Start();
     }
 }
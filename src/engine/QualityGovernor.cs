@@ -0,0 +1,291 @@
+using System;
+using System.Collections.Generic;
+using System.Text;
+using Godot;
+
+/// <summary>
+///   Adjusts the performance related values at runtime to keep the frame time within a budget
+/// </summary>
+/// <remarks>
+///   <para>
+///     The systems report how long their updates take, and the governor degrades the knob belonging to the most
+///     expensive system when the frame cost stays over the budget. Quality is restored one step at a time, in
+///     the reverse order, once there has been plenty of headroom for a while. The different delays and margins
+///     for degrading and improving keep this from oscillating between two levels.
+///   </para>
+///   <para>
+///     When Settings.AutomaticQuality is off all the values just follow the settings and constants.
+///   </para>
+/// </remarks>
+public class QualityGovernor
+{
+    private static readonly QualityGovernor SingletonInstance = new QualityGovernor();
+
+    private readonly float[] systemCosts = new float[Enum.GetValues(typeof(GovernedSystem)).Length];
+
+    /// <summary>
+    ///   The applied degrade steps, undone from the top when improving
+    /// </summary>
+    private readonly Stack<Knob> appliedSteps = new Stack<Knob>();
+
+    private readonly int[] knobLevels = new int[Enum.GetValues(typeof(Knob)).Length];
+
+    /// <summary>
+    ///   Sum of the system times reported since the last Update
+    /// </summary>
+    private float reportedFrameTime;
+
+    private float smoothedFrameCost;
+
+    private float overBudgetTime;
+    private float underBudgetTime;
+
+    static QualityGovernor()
+    {
+    }
+
+    private QualityGovernor()
+    {
+    }
+
+    /// <summary>
+    ///   The systems whose cost is tracked
+    /// </summary>
+    public enum GovernedSystem
+    {
+        Clouds,
+        Processes,
+        AI,
+        Spawning,
+        Physics,
+    }
+
+    /// <summary>
+    ///   The values that are degraded to reduce the frame cost
+    /// </summary>
+    public enum Knob
+    {
+        CloudUpdateInterval,
+        CloudResolution,
+        MaxAliveEntities,
+    }
+
+    public static QualityGovernor Instance => SingletonInstance;
+
+    /// <summary>
+    ///   The governor holds still in deterministic runs as its changes depend on the timing
+    /// </summary>
+    public bool Enabled => Settings.Instance.AutomaticQuality && !SimulationRandom.Deterministic;
+
+    /// <summary>
+    ///   The time the governed systems may take in one frame, in milliseconds
+    /// </summary>
+    public float FrameBudget => 1000.0f / Math.Max(1, Settings.Instance.TargetFrameRate.Value) *
+        Constants.QUALITY_GOVERNOR_CPU_BUDGET_FRACTION;
+
+    /// <summary>
+    ///   Smoothed time the governed systems took per frame, in milliseconds
+    /// </summary>
+    public float FrameCost => smoothedFrameCost;
+
+    public float CloudUpdateInterval
+    {
+        get
+        {
+            float interval = Settings.Instance.CloudUpdateInterval;
+
+            if (!Enabled)
+                return interval;
+
+            return Math.Max(interval,
+                knobLevels[(int)Knob.CloudUpdateInterval] * Constants.QUALITY_GOVERNOR_CLOUD_INTERVAL_STEP);
+        }
+    }
+
+    /// <summary>
+    ///   The resolution newly created cloud planes should use. Existing clouds aren't resized, so changes to this
+    ///   only apply when the stage is next entered.
+    /// </summary>
+    public int CloudResolution
+    {
+        get
+        {
+            int resolution = Settings.Instance.CloudResolution;
+
+            if (!Enabled)
+                return resolution;
+
+            return Math.Min(resolution << knobLevels[(int)Knob.CloudResolution],
+                Constants.QUALITY_GOVERNOR_MAX_CLOUD_RESOLUTION);
+        }
+    }
+
+    /// <summary>
+    ///   The fraction of the normal entity limit that is currently allowed to spawn
+    /// </summary>
+    public float EntityFraction => Math.Max(Constants.QUALITY_GOVERNOR_MIN_ENTITY_FRACTION,
+        1.0f - knobLevels[(int)Knob.MaxAliveEntities] * Constants.QUALITY_GOVERNOR_ENTITY_STEP);
+
+    /// <summary>
+    ///   Task sizes of the process system. These adapt to the measured cost even when this is disabled.
+    /// </summary>
+    public TaskSizeTuner ProcessTasks { get; } = new TaskSizeTuner(Constants.PROCESS_OBJECTS_PER_TASK);
+
+    public TaskSizeTuner AITasks { get; } = new TaskSizeTuner(Constants.MICROBE_AI_OBJECTS_PER_TASK);
+
+    /// <summary>
+    ///   Applies the current entity limit reduction to a spawn limit
+    /// </summary>
+    public int LimitAliveEntities(int maxAliveEntities)
+    {
+        if (!Enabled)
+            return maxAliveEntities;
+
+        return (int)(maxAliveEntities * EntityFraction);
+    }
+
+    /// <summary>
+    ///   Reports how long a system took this frame
+    /// </summary>
+    /// <param name="system">The system</param>
+    /// <param name="milliseconds">Time spent</param>
+    public void ReportSystemTime(GovernedSystem system, float milliseconds)
+    {
+        systemCosts[(int)system] = Mathf.Lerp(systemCosts[(int)system], milliseconds,
+            Constants.QUALITY_GOVERNOR_SMOOTHING);
+
+        reportedFrameTime += milliseconds;
+    }
+
+    public float GetSystemCost(GovernedSystem system)
+    {
+        return systemCosts[(int)system];
+    }
+
+    /// <summary>
+    ///   Updates the decisions. Should be called once per frame by the active stage.
+    /// </summary>
+    public void Update(float delta)
+    {
+        // The cost is the time the governed systems took since the last update, measured by the systems
+        // themselves. Engine monitors like TimeProcess are per second maximums that include rendering and
+        // waiting for vsync, so they can't tell when the game logic is over the budget.
+        var frameCost = reportedFrameTime;
+        reportedFrameTime = 0;
+
+        smoothedFrameCost = Mathf.Lerp(smoothedFrameCost, frameCost, Constants.QUALITY_GOVERNOR_SMOOTHING);
+
+        if (!Enabled)
+            return;
+
+        var budget = FrameBudget;
+
+        if (smoothedFrameCost > budget * (1.0f + Constants.QUALITY_GOVERNOR_DEGRADE_MARGIN))
+        {
+            overBudgetTime += delta;
+            underBudgetTime = 0;
+        }
+        else if (smoothedFrameCost < budget * (1.0f - Constants.QUALITY_GOVERNOR_IMPROVE_MARGIN))
+        {
+            underBudgetTime += delta;
+            overBudgetTime = 0;
+        }
+        else
+        {
+            overBudgetTime = 0;
+            underBudgetTime = 0;
+        }
+
+        if (overBudgetTime >= Constants.QUALITY_GOVERNOR_DEGRADE_DELAY)
+        {
+            overBudgetTime = 0;
+            Degrade();
+        }
+        else if (underBudgetTime >= Constants.QUALITY_GOVERNOR_IMPROVE_DELAY)
+        {
+            underBudgetTime = 0;
+            Improve();
+        }
+    }
+
+    /// <summary>
+    ///   Returns a summary of the current decisions for showing in the GUI
+    /// </summary>
+    public string GetStatusText()
+    {
+        var builder = new StringBuilder();
+
+        if (Enabled)
+        {
+            builder.AppendFormat("Frame cost: {0:F1} / {1:F1} ms\n", smoothedFrameCost, FrameBudget);
+            builder.AppendFormat("Cloud update interval: {0} ms\n", Mathf.RoundToInt(CloudUpdateInterval * 1000));
+            builder.AppendFormat("Cloud resolution divisor (next stage): {0}\n", CloudResolution);
+            builder.AppendFormat("Spawn limit: {0}%\n", Mathf.RoundToInt(EntityFraction * 100));
+        }
+        else
+        {
+            builder.Append("Automatic quality is disabled\n");
+        }
+
+        // The task sizes adapt even when the governor is disabled
+        builder.AppendFormat("Process tasks: {0}\n", ProcessTasks.GetStatusText());
+        builder.AppendFormat("AI tasks: {0}\n", AITasks.GetStatusText());
+
+        foreach (GovernedSystem system in Enum.GetValues(typeof(GovernedSystem)))
+        {
+            builder.AppendFormat("{0}: {1:F2} ms\n", system, GetSystemCost(system));
+        }
+
+        return builder.ToString();
+    }
+
+    private void Degrade()
+    {
+        // Clouds have their own knobs, everything else scales with the number of entities
+        float cloudCost = systemCosts[(int)GovernedSystem.Clouds];
+        float entityCost = systemCosts[(int)GovernedSystem.Processes] + systemCosts[(int)GovernedSystem.AI] +
+            systemCosts[(int)GovernedSystem.Spawning] + systemCosts[(int)GovernedSystem.Physics];
+
+        var preferred = cloudCost >= entityCost ?
+            new[] { Knob.CloudUpdateInterval, Knob.CloudResolution, Knob.MaxAliveEntities } :
+            new[] { Knob.MaxAliveEntities, Knob.CloudUpdateInterval, Knob.CloudResolution };
+
+        foreach (var knob in preferred)
+        {
+            if (knobLevels[(int)knob] >= MaxLevel(knob))
+                continue;
+
+            ++knobLevels[(int)knob];
+            appliedSteps.Push(knob);
+
+            GD.Print("Quality governor: frame cost ", smoothedFrameCost, " ms is over budget, degrading ", knob);
+            return;
+        }
+    }
+
+    private void Improve()
+    {
+        if (appliedSteps.Count < 1)
+            return;
+
+        var knob = appliedSteps.Pop();
+        --knobLevels[(int)knob];
+
+        GD.Print("Quality governor: frame cost ", smoothedFrameCost, " ms has headroom, improving ", knob);
+    }
+
+    private int MaxLevel(Knob knob)
+    {
+        switch (knob)
+        {
+            case Knob.CloudUpdateInterval:
+                return Constants.QUALITY_GOVERNOR_MAX_CLOUD_INTERVAL_LEVEL;
+            case Knob.CloudResolution:
+                return Constants.QUALITY_GOVERNOR_MAX_CLOUD_RESOLUTION_LEVEL;
+            case Knob.MaxAliveEntities:
+                return Constants.QUALITY_GOVERNOR_MAX_ENTITY_LEVEL;
+            default:
+                throw new ArgumentOutOfRangeException(nameof(knob), knob, null);
+        }
+    }
+}
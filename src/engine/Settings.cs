@@ -136,6 +136,23 @@ public class Settings
     /// </summary>
     public SettingValue<bool> RunAutoEvoDuringGamePlay { get; set; } = new SettingValue<bool>(true);
 
+    /// <summary>
+    ///   If true the microbe stage entities are simulated with the planar physics system instead of the
+    ///   Godot 3D physics. Only applies when the stage is entered.
+    /// </summary>
+    public SettingValue<bool> PlanarPhysics { get; set; } = new SettingValue<bool>(false);
+
+    /// <summary>
+    ///   If true the performance values are automatically lowered when the game can't keep up with the
+    ///   target frame rate
+    /// </summary>
+    public SettingValue<bool> AutomaticQuality { get; set; } = new SettingValue<bool>(false);
+
+    /// <summary>
+    ///   The frame rate automatic quality tries to hold
+    /// </summary>
+    public SettingValue<int> TargetFrameRate { get; set; } = new SettingValue<int>(60);
+
     // Misc Properties
 
     /// <summary>
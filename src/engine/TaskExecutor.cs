@@ -2,6 +2,7 @@
 using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
 using Godot;
 using Environment = System.Environment;
@@ -16,6 +17,12 @@ public class TaskExecutor
 {
     private static readonly TaskExecutor SingletonInstance = new TaskExecutor();
 
+    /// <summary>
+    ///   Bytes allocated on the executor threads by the tasks from the RunTasks calls of the current thread
+    /// </summary>
+    [ThreadStatic]
+    private static long workerAllocatedBytes;
+
     private readonly BlockingCollection<ThreadCommand> queuedTasks =
         new BlockingCollection<ThreadCommand>();
 
@@ -91,6 +98,13 @@ public class TaskExecutor
         }
     }
 
+    /// <summary>
+    ///   Total bytes allocated by the tasks the calling thread started with RunTasks that were run on the executor
+    ///   threads. Used for counting the allocations of the parallel parts of the systems. This is per thread so
+    ///   that RunTasks calls from other threads don't get counted.
+    /// </summary>
+    public long WorkerAllocatedBytes => workerAllocatedBytes;
+
     /// <summary>
     ///   Sends a new task to be executed
     /// </summary>
@@ -98,7 +112,7 @@ public class TaskExecutor
     {
         if (task != null)
         {
-            queuedTasks.Add(new ThreadCommand(ThreadCommand.Type.Task, task));
+            queuedTasks.Add(new ThreadCommand(ThreadCommand.Type.Task, task, null));
         }
     }
 
@@ -111,12 +125,16 @@ public class TaskExecutor
         // Queue all but the first task
         Task firstTask = null;
 
+        // Each call has its own measurement so that calls from different threads don't wait for each other
+        var measurement = new TaskMeasurement();
+
         var enumerated = tasks.ToList();
         foreach (var task in enumerated)
         {
             if (firstTask != null)
             {
-                AddTask(task);
+                Interlocked.Increment(ref measurement.UnmeasuredTasks);
+                queuedTasks.Add(new ThreadCommand(ThreadCommand.Type.MeasuredTask, task, measurement));
             }
             else
             {
@@ -132,6 +150,15 @@ public class TaskExecutor
         {
             task.Wait();
         }
+
+        // The allocations are added just after the tasks complete, wait for that so that they are counted for
+        // the right system
+        var spinner = default(SpinWait);
+
+        while (Volatile.Read(ref measurement.UnmeasuredTasks) > 0)
+            spinner.SpinOnce();
+
+        workerAllocatedBytes += Interlocked.Read(ref measurement.AllocatedBytes);
     }
 
     public void Quit()
@@ -154,7 +181,7 @@ public class TaskExecutor
         if (currentThreadCount <= 0)
             return;
 
-        queuedTasks.Add(new ThreadCommand(ThreadCommand.Type.Quit, null));
+        queuedTasks.Add(new ThreadCommand(ThreadCommand.Type.Quit, null, null));
 
         --currentThreadCount;
     }
@@ -170,8 +197,15 @@ public class TaskExecutor
                     return;
                 }
 
-                if (command.CommandType == ThreadCommand.Type.Task)
+                if (command.CommandType == ThreadCommand.Type.Task ||
+                    command.CommandType == ThreadCommand.Type.MeasuredTask)
                 {
+                    // The heap size fallback is process wide so it would count the main thread allocations again
+                    bool measure = command.CommandType == ThreadCommand.Type.MeasuredTask &&
+                        AllocationTracker.IsPerThread;
+
+                    long allocationStart = measure ? AllocationTracker.CurrentThreadAllocatedBytes() : 0;
+
                     try
                     {
                         command.Task.RunSynchronously();
@@ -179,9 +213,22 @@ public class TaskExecutor
                     catch (TaskSchedulerException exception)
                     {
                         GD.Print("Background task failed due to thread exiting: ", exception.Message);
+
+                        if (command.CommandType == ThreadCommand.Type.MeasuredTask)
+                            Interlocked.Decrement(ref command.Measurement.UnmeasuredTasks);
+
                         return;
                     }
 
+                    if (measure)
+                    {
+                        Interlocked.Add(ref command.Measurement.AllocatedBytes,
+                            AllocationTracker.CurrentThreadAllocatedBytes() - allocationStart);
+                    }
+
+                    if (command.CommandType == ThreadCommand.Type.MeasuredTask)
+                        Interlocked.Decrement(ref command.Measurement.UnmeasuredTasks);
+
                     // Make sure task exceptions aren't ignored.
                     // Could perhaps in the future find some other way to handle this
                     if (command.Task.Exception != null)
@@ -200,16 +247,40 @@ public class TaskExecutor
         public Type CommandType;
         public Task Task;
 
-        public ThreadCommand(Type commandType, Task task)
+        /// <summary>
+        ///   The RunTasks call a MeasuredTask is from
+        /// </summary>
+        public TaskMeasurement Measurement;
+
+        public ThreadCommand(Type commandType, Task task, TaskMeasurement measurement)
         {
             CommandType = commandType;
             Task = task;
+            Measurement = measurement;
         }
 
         public enum Type
         {
             Task,
+
+            /// <summary>
+            ///   A task from RunTasks, whose allocations are counted
+            /// </summary>
+            MeasuredTask,
             Quit,
         }
     }
+
+    /// <summary>
+    ///   Allocations of the tasks queued by one RunTasks call
+    /// </summary>
+    private class TaskMeasurement
+    {
+        public long AllocatedBytes;
+
+        /// <summary>
+        ///   Tasks whose allocations haven't been added yet
+        /// </summary>
+        public int UnmeasuredTasks;
+    }
 }
@@ -0,0 +1,180 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using Godot;
+using Thread = System.Threading.Thread;
+
+/// <summary>
+///   Picks how many objects each parallel task of a system processes, based on the measured cost per object
+/// </summary>
+/// <remarks>
+///   <para>
+///     Tasks are sized to take about Constants.TARGET_TASK_DURATION, but are made smaller when that would leave
+///     some of the threads without work. The tasks report how long they ran and on which thread, which is used
+///     both for measuring the object cost and for showing how evenly the work was spread.
+///   </para>
+/// </remarks>
+public class TaskSizeTuner
+{
+    private readonly int defaultObjectsPerTask;
+
+    private readonly Stopwatch stopwatch = new Stopwatch();
+
+    /// <summary>
+    ///   Busy time of each thread in the current run, keyed by the managed thread id
+    /// </summary>
+    private readonly Dictionary<int, long> threadBusyTicks = new Dictionary<int, long>();
+
+    private readonly object statisticsLock = new object();
+
+    /// <summary>
+    ///   Smoothed time one object takes to process, in milliseconds. Negative until measured.
+    /// </summary>
+    private float objectCost = -1;
+
+    private long runBusyTicks;
+    private int runObjects;
+
+    public TaskSizeTuner(int defaultObjectsPerTask)
+    {
+        this.defaultObjectsPerTask = defaultObjectsPerTask;
+        ObjectsPerTask = defaultObjectsPerTask;
+    }
+
+    public int ObjectsPerTask { get; private set; }
+
+    public int TaskCount { get; private set; }
+
+    /// <summary>
+    ///   How many threads ran tasks in the last run
+    /// </summary>
+    public int ThreadsUsed { get; private set; }
+
+    /// <summary>
+    ///   Busy time of the most loaded thread divided by the average busy time of the threads in the last run.
+    ///   1 is a perfectly even split.
+    /// </summary>
+    public float LoadImbalance { get; private set; } = 1.0f;
+
+    /// <summary>
+    ///   Total busy time of the threads divided by the wall time times the available threads in the last run
+    /// </summary>
+    public float ParallelEfficiency { get; private set; } = 1.0f;
+
+    public float ObjectCost => objectCost;
+
+    /// <summary>
+    ///   Starts a new run and calculates the task size for it
+    /// </summary>
+    /// <param name="objectCount">Number of objects to process</param>
+    /// <returns>How many objects each task should process</returns>
+    public int BeginRun(int objectCount)
+    {
+        ObjectsPerTask = CalculateObjectsPerTask(objectCount);
+        TaskCount = (objectCount + ObjectsPerTask - 1) / ObjectsPerTask;
+
+        threadBusyTicks.Clear();
+        runBusyTicks = 0;
+        runObjects = 0;
+
+        stopwatch.Restart();
+        return ObjectsPerTask;
+    }
+
+    /// <summary>
+    ///   Called by a task when it starts
+    /// </summary>
+    /// <returns>Start time to pass to TaskFinished</returns>
+    public long TaskStarted()
+    {
+        return stopwatch.ElapsedTicks;
+    }
+
+    /// <summary>
+    ///   Called by a task once it has processed its objects. Thread safe.
+    /// </summary>
+    public void TaskFinished(long startTicks, int objects)
+    {
+        var elapsed = stopwatch.ElapsedTicks - startTicks;
+        var thread = Thread.CurrentThread.ManagedThreadId;
+
+        lock (statisticsLock)
+        {
+            threadBusyTicks.TryGetValue(thread, out long busy);
+            threadBusyTicks[thread] = busy + elapsed;
+
+            runBusyTicks += elapsed;
+            runObjects += objects;
+        }
+    }
+
+    /// <summary>
+    ///   Ends the run after all the tasks have finished and updates the measurements
+    /// </summary>
+    public void EndRun()
+    {
+        var wallTicks = stopwatch.ElapsedTicks;
+        stopwatch.Stop();
+
+        ThreadsUsed = threadBusyTicks.Count;
+
+        if (ThreadsUsed < 1 || runObjects < 1)
+            return;
+
+        long maxBusy = 0;
+
+        foreach (var entry in threadBusyTicks)
+            maxBusy = Math.Max(maxBusy, entry.Value);
+
+        var averageBusy = runBusyTicks / (float)ThreadsUsed;
+        LoadImbalance = averageBusy > 0 ? maxBusy / averageBusy : 1.0f;
+
+        ParallelEfficiency = wallTicks > 0 ?
+            runBusyTicks / (float)(wallTicks * AvailableThreads()) :
+            1.0f;
+
+        var measuredCost = (float)(runBusyTicks * 1000.0 / Stopwatch.Frequency) / runObjects;
+
+        objectCost = objectCost < 0 ?
+            measuredCost :
+            Mathf.Lerp(objectCost, measuredCost, Constants.TASK_SIZE_COST_SMOOTHING);
+    }
+
+    public string GetStatusText()
+    {
+        return $"{ObjectsPerTask} per task, {TaskCount} tasks on {ThreadsUsed} threads, " +
+            $"imbalance {LoadImbalance:F2}, efficiency {ParallelEfficiency:P0}";
+    }
+
+    /// <summary>
+    ///   The executor threads and the calling thread, which runs the first task
+    /// </summary>
+    private static int AvailableThreads()
+    {
+        return TaskExecutor.Instance.ParallelTasks + 1;
+    }
+
+    private int CalculateObjectsPerTask(int objectCount)
+    {
+        if (objectCount < 1)
+            return Math.Max(1, defaultObjectsPerTask);
+
+        if (objectCost <= 0)
+            return defaultObjectsPerTask;
+
+        int size = Math.Max(1, (int)Math.Min(Constants.TARGET_TASK_DURATION / objectCost, objectCount));
+
+        // Split the work over all the threads if that still keeps the tasks long enough to be worth it
+        int threads = AvailableThreads();
+
+        if ((objectCount + size - 1) / size < threads)
+        {
+            int minimumSize = (int)Math.Ceiling(Math.Min(Constants.MIN_TASK_DURATION / objectCost, objectCount));
+            int evenSplit = (objectCount + threads - 1) / threads;
+
+            size = Math.Max(evenSplit, minimumSize);
+        }
+
+        return Mathf.Clamp(size, 1, objectCount);
+    }
+}
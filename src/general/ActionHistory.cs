@@ -19,6 +19,12 @@ public class ActionHistory<T>
     [JsonProperty]
     private int actionIndex;
 
+    /// <summary>
+    ///   The number of stored actions, including the undone ones
+    /// </summary>
+    [JsonIgnore]
+    public int ActionCount => actions.Count;
+
     public bool CanRedo()
     {
         return actionIndex < actions.Count;
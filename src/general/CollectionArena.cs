@@ -0,0 +1,144 @@
+using System;
+using System.Collections.Generic;
+
+/// <summary>
+///   Pool of lists and dictionaries that are only needed for a short while, like during one frame or one
+///   simulation step. The collections are borrowed from the arena and all of them are given back at once with
+///   Reset, so code running every frame doesn't need to allocate new collections.
+/// </summary>
+/// <remarks>
+///   <para>
+///     A borrowed collection is empty and may be used until the next Reset, after which it is cleared and handed
+///     out again. So borrowed collections must not be stored anywhere that outlives the frame or step. The arena is
+///     not thread safe, only the thread that owns it may borrow. Collections filled before starting tasks may be
+///     read by the tasks.
+///   </para>
+/// </remarks>
+public class CollectionArena
+{
+    private readonly Dictionary<Type, IPool> pools = new Dictionary<Type, IPool>();
+
+    /// <summary>
+    ///   Number of collections currently borrowed
+    /// </summary>
+    public int BorrowedCount
+    {
+        get
+        {
+            int count = 0;
+
+            foreach (var pool in pools.Values)
+                count += pool.Borrowed;
+
+            return count;
+        }
+    }
+
+    /// <summary>
+    ///   Number of collections the arena holds in total
+    /// </summary>
+    public int PooledCount
+    {
+        get
+        {
+            int count = 0;
+
+            foreach (var pool in pools.Values)
+                count += pool.Borrowed + pool.Free;
+
+            return count;
+        }
+    }
+
+    /// <summary>
+    ///   Borrows an empty list that is valid until the next Reset
+    /// </summary>
+    public List<T> BorrowList<T>()
+    {
+        return GetPool<List<T>>(list => list.Clear()).Borrow();
+    }
+
+    /// <summary>
+    ///   Borrows a list filled with the items, valid until the next Reset
+    /// </summary>
+    public List<T> BorrowList<T>(IEnumerable<T> items)
+    {
+        var list = BorrowList<T>();
+        list.AddRange(items);
+        return list;
+    }
+
+    /// <summary>
+    ///   Borrows an empty dictionary that is valid until the next Reset
+    /// </summary>
+    public Dictionary<TKey, TValue> BorrowDictionary<TKey, TValue>()
+    {
+        return GetPool<Dictionary<TKey, TValue>>(dictionary => dictionary.Clear()).Borrow();
+    }
+
+    /// <summary>
+    ///   Clears all the borrowed collections and makes them available to borrow again
+    /// </summary>
+    public void Reset()
+    {
+        foreach (var pool in pools.Values)
+            pool.Reset();
+    }
+
+    private Pool<TCollection> GetPool<TCollection>(Action<TCollection> clear)
+        where TCollection : class, new()
+    {
+        if (pools.TryGetValue(typeof(TCollection), out var pool))
+            return (Pool<TCollection>)pool;
+
+        var created = new Pool<TCollection>(clear);
+        pools[typeof(TCollection)] = created;
+        return created;
+    }
+
+    private interface IPool
+    {
+        int Borrowed { get; }
+        int Free { get; }
+
+        void Reset();
+    }
+
+    private class Pool<TCollection> : IPool
+        where TCollection : class, new()
+    {
+        private readonly List<TCollection> borrowed = new List<TCollection>();
+        private readonly Stack<TCollection> free = new Stack<TCollection>();
+        private readonly Action<TCollection> clear;
+
+        public Pool(Action<TCollection> clear)
+        {
+            this.clear = clear;
+        }
+
+        public int Borrowed => borrowed.Count;
+        public int Free => free.Count;
+
+        public TCollection Borrow()
+        {
+            var collection = free.Count > 0 ? free.Pop() : new TCollection();
+            borrowed.Add(collection);
+            return collection;
+        }
+
+        public void Reset()
+        {
+            foreach (var collection in borrowed)
+            {
+                clear(collection);
+
+                // Collections over the limit are left for the garbage collector so that one busy frame doesn't
+                // keep lots of them around
+                if (free.Count < Constants.COLLECTION_ARENA_MAX_FREE_PER_TYPE)
+                    free.Push(collection);
+            }
+
+            borrowed.Clear();
+        }
+    }
+}
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Linq;
 using Godot;
 using Newtonsoft.Json;
 
@@ -12,7 +13,7 @@ using Newtonsoft.Json;
 ///     but now this is just a collection of data regarding the world.
 ///   </para>
 /// </remarks>
-public class GameWorld
+public class GameWorld : IMemoryReporter
 {
     [JsonProperty]
     private uint speciesIdCounter;
@@ -34,12 +35,25 @@ public class GameWorld
     /// </remarks>
     private AutoEvoRun autoEvo;
 
+    private AutoEvoFastForward fastForward;
+
+    /// <summary>
+    ///   Seeds the Randoms this world's generation and auto-evo runs use
+    /// </summary>
+    private Random seedSource;
+
     /// <summary>
     ///   Creates a new world
     /// </summary>
     /// <param name="settings">Settings to generate the world with</param>
     public GameWorld(WorldGenerationSettings settings) : this()
     {
+        if (settings.Seed.HasValue)
+        {
+            seedSource = new Random(settings.Seed.Value);
+            mutator = new Mutations(CreateRandom());
+        }
+
         PlayerSpecies = CreatePlayerSpecies();
 
         Map = PatchMapGenerator.Generate(settings, PlayerSpecies);
@@ -49,6 +63,7 @@ public class GameWorld
 
         // Apply initial populations
         Map.UpdateGlobalPopulations();
+        PopulationHistory.Record(Map, TotalPassedTime);
     }
 
     /// <summary>
@@ -56,6 +71,8 @@ public class GameWorld
     /// </summary>
     public GameWorld()
     {
+        seedSource = SimulationRandom.Create();
+
         // TODO: save timed effects to json as well
         TimedEffects = new TimedWorldOperations();
 
@@ -93,9 +110,27 @@ public class GameWorld
     [JsonProperty]
     public double TotalPassedTime { get; private set; }
 
+    /// <summary>
+    ///   The clouds of the patches the player has left
+    /// </summary>
+    [JsonProperty]
+    public PatchSnapshotCache PatchSnapshots { get; private set; } = new PatchSnapshotCache();
+
+    /// <summary>
+    ///   Populations of the species in each patch over the latest generations
+    /// </summary>
+    [JsonProperty]
+    public PopulationHistory PopulationHistory { get; private set; } = new PopulationHistory();
+
     [JsonIgnore]
     public TimedWorldOperations TimedEffects { get; }
 
+    /// <summary>
+    ///   True while an auto-evo fast forward is running, nothing else may use the world then
+    /// </summary>
+    [JsonIgnore]
+    public bool IsFastForwarding => fastForward != null && !fastForward.Finished;
+
     public static void SetInitialSpeciesProperties(MicrobeSpecies species)
     {
         species.IsBacteria = true;
@@ -138,7 +173,7 @@ public class GameWorld
     /// </summary>
     public void GenerateRandomSpeciesForFreeBuild()
     {
-        var random = new Random();
+        var random = CreateRandom();
 
         foreach (var entry in Map.Patches)
         {
@@ -155,6 +190,18 @@ public class GameWorld
         }
     }
 
+    /// <summary>
+    ///   Creates a Random seeded from this world's seed. Worlds don't share these so each world can be simulated
+    ///   in its own thread.
+    /// </summary>
+    public Random CreateRandom()
+    {
+        lock (seedSource)
+        {
+            return new Random(seedSource.Next());
+        }
+    }
+
     /// <summary>
     ///   Simulate long term world time passing
     /// </summary>
@@ -184,6 +231,10 @@ public class GameWorld
     /// </summary>
     public bool IsAutoEvoFinished(bool autostart = true)
     {
+        // The fast forward runs its own auto-evo runs on this world
+        if (IsFastForwarding)
+            return false;
+
         if (autoEvo == null && autostart)
         {
             CreateRunIfMissing();
@@ -196,6 +247,14 @@ public class GameWorld
         return autoEvo.Finished;
     }
 
+    /// <summary>
+    ///   Returns the current auto-evo run without starting one
+    /// </summary>
+    public AutoEvoRun GetAutoEvoRunIfStarted()
+    {
+        return autoEvo;
+    }
+
     public AutoEvoRun GetAutoEvoRun()
     {
         IsAutoEvoFinished();
@@ -203,6 +262,49 @@ public class GameWorld
         return autoEvo;
     }
 
+    /// <summary>
+    ///   Starts running a number of auto-evo generations back to back in the background
+    /// </summary>
+    /// <param name="generations">How many generations to run</param>
+    /// <param name="playerCantGoExtinct">Passed to RemoveExtinctSpecies after each generation</param>
+    public AutoEvoFastForward StartAutoEvoFastForward(int generations, bool playerCantGoExtinct)
+    {
+        if (autoEvo != null || IsFastForwarding)
+            throw new InvalidOperationException("Auto-evo is already running for this world");
+
+        fastForward = new AutoEvoFastForward(this, generations, playerCantGoExtinct);
+        fastForward.Start();
+
+        return fastForward;
+    }
+
+    /// <summary>
+    ///   Returns the latest fast forward, null if there hasn't been one
+    /// </summary>
+    public AutoEvoFastForward GetAutoEvoFastForwardIfStarted()
+    {
+        return fastForward;
+    }
+
+    /// <summary>
+    ///   Applies the results of a finished auto-evo run and removes the species that went extinct
+    /// </summary>
+    /// <returns>The species that went extinct</returns>
+    public List<Species> ApplyAutoEvoResults(AutoEvoRun run, bool playerCantGoExtinct)
+    {
+        run.ApplyExternalEffects();
+
+        var extinct = Map.RemoveExtinctSpecies(playerCantGoExtinct);
+
+        foreach (var species in extinct)
+            RemoveSpecies(species);
+
+        Map.UpdateGlobalPopulations();
+        PopulationHistory.Record(Map, TotalPassedTime);
+
+        return extinct;
+    }
+
     /// <summary>
     ///   Stops and removes any auto-evo runs for this world
     /// </summary>
@@ -260,6 +362,25 @@ public class GameWorld
         return worldSpecies[id];
     }
 
+    public void ReportMemory(MemoryReport report)
+    {
+        report.Add("World", "species", 0, worldSpecies.Count);
+        report.Add("World", "species organelles", 0,
+            worldSpecies.Values.OfType<MicrobeSpecies>().Sum(species => species.Organelles.Count));
+
+        report.Add("World", "interned genomes", 0, MicrobeGenome.InternedCount);
+
+        report.Add("World", "patches", 0, Map.Patches.Count);
+        report.Add("World", "patch populations", 0,
+            Map.Patches.Values.Sum(patch => patch.SpeciesInPatch.Count));
+
+        if (autoEvo != null)
+            report.Add("World", "auto-evo external effects", 0, autoEvo.ExternalEffects.Count);
+
+        report.Add("World", "patch snapshots", PatchSnapshots.TotalBytes, PatchSnapshots.Count);
+        report.Add("World", "population history columns", PopulationHistory.Bytes, PopulationHistory.ColumnCount);
+    }
+
     private void CreateRunIfMissing()
     {
         if (autoEvo != null)
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Runtime.InteropServices;
 using Godot;
 
 /// <summary>
@@ -63,4 +64,54 @@ public static class MathUtils
         return new Quat(new Vector3(-1, 0, 0), 90 * DEGREES_TO_RADIANS) *
             new Quat(new Vector3(0, 0, -1), (180 - angle) * DEGREES_TO_RADIANS);
     }
+
+    /// <summary>
+    ///   Converts a float to IEEE 754 half precision bits. Values too large are converted to infinity and values
+    ///   too small to be represented as normal half floats are flushed to zero.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     This is used to fill half-float textures (Image.Format.Rgbah) without going through SetPixel
+    ///   </para>
+    /// </remarks>
+    public static ushort FloatToHalf(float value)
+    {
+        var bits = new FloatBits { Float = value }.Int;
+
+        int sign = (bits >> 16) & 0x8000;
+        int exponent = ((bits >> 23) & 0xff) - 127 + 15;
+        int mantissa = bits & 0x007fffff;
+
+        // NaN
+        if (exponent == 128 + 15 && mantissa != 0)
+            return (ushort)(sign | 0x7e00);
+
+        // Too large, or infinity
+        if (exponent >= 31)
+            return (ushort)(sign | 0x7c00);
+
+        // Too small for a normal half float
+        if (exponent <= 0)
+            return (ushort)sign;
+
+        // Round to nearest
+        int half = sign | (exponent << 10) | (mantissa >> 13);
+        if ((mantissa & 0x1000) != 0)
+            ++half;
+
+        return (ushort)half;
+    }
+
+    /// <summary>
+    ///   Used to reinterpret float bits without unsafe code
+    /// </summary>
+    [StructLayout(LayoutKind.Explicit)]
+    private struct FloatBits
+    {
+        [FieldOffset(0)]
+        public float Float;
+
+        [FieldOffset(0)]
+        public int Int;
+    }
 }
@@ -28,7 +28,25 @@ public class Mutations
     };
 
     [JsonProperty]
-    private Random random = new Random();
+    private Random random;
+
+    public Mutations() : this(new Random())
+    {
+    }
+
+    /// <summary>
+    ///   Creates mutations that use the given random, with a seeded random the results repeat between runs
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     Each Mutations may only be used by one thread at a time, worlds simulated in parallel each need their
+    ///     own.
+    ///   </para>
+    /// </remarks>
+    public Mutations(Random random)
+    {
+        this.random = random;
+    }
 
     /// <summary>
     ///   Creates a mutated version of a species
@@ -52,7 +70,7 @@ public class Mutations
         }
         else
         {
-            mutated.Epithet = nameGenerator.GenerateNameSection();
+            mutated.Epithet = nameGenerator.GenerateNameSection(random);
         }
 
         mutated.Genus = parent.Genus;
@@ -68,7 +86,7 @@ public class Mutations
             }
             else
             {
-                mutated.Genus = nameGenerator.GenerateNameSection();
+                mutated.Genus = nameGenerator.GenerateNameSection(random);
             }
         }
 
@@ -129,6 +147,7 @@ public class Mutations
             random.Next(-25, 26) / 100.0f, 1), -1);
 
         mutated.UpdateInitialCompounds();
+        mutated.UpdateGenome();
 
         return mutated;
     }
@@ -145,8 +164,8 @@ public class Mutations
 
         // Override the default species starting name to have more variability in the names
         var nameGenerator = SimulationParameters.Instance.NameGenerator;
-        temp.Epithet = nameGenerator.GenerateNameSection();
-        temp.Genus = nameGenerator.GenerateNameSection();
+        temp.Epithet = nameGenerator.GenerateNameSection(random);
+        temp.Genus = nameGenerator.GenerateNameSection(random);
 
         for (int step = 0; step < steps; ++step)
         {
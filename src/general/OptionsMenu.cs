@@ -97,6 +97,15 @@ public class OptionsMenu : Control
     [Export]
     public NodePath CloudResolutionPath;
 
+    [Export]
+    public NodePath AutomaticQualityPath;
+
+    [Export]
+    public NodePath TargetFrameRatePath;
+
+    [Export]
+    public NodePath QualityGovernorStatusPath;
+
     // Misc tab.
     [Export]
     public NodePath MiscTabPath;
@@ -169,6 +178,9 @@ public class OptionsMenu : Control
     private Control performanceTab;
     private OptionButton cloudInterval;
     private OptionButton cloudResolution;
+    private CheckBox automaticQuality;
+    private SpinBox targetFrameRate;
+    private Label qualityGovernorStatus;
 
     // Misc tab
     private Control miscTab;
@@ -263,6 +275,9 @@ public class OptionsMenu : Control
         performanceTab = GetNode<Control>(PerformanceTabPath);
         cloudInterval = GetNode<OptionButton>(CloudIntervalPath);
         cloudResolution = GetNode<OptionButton>(CloudResolutionPath);
+        automaticQuality = GetNode<CheckBox>(AutomaticQualityPath);
+        targetFrameRate = GetNode<SpinBox>(TargetFrameRatePath);
+        qualityGovernorStatus = GetNode<Label>(QualityGovernorStatusPath);
 
         // Misc
         miscTab = GetNode<Control>(MiscTabPath);
@@ -282,6 +297,13 @@ public class OptionsMenu : Control
         selectedOptionsTab = SelectedOptionsTab.Graphics;
     }
 
+    public override void _Process(float delta)
+    {
+        // Show what the quality governor is currently doing
+        if (performanceTab.IsVisibleInTree())
+            qualityGovernorStatus.Text = QualityGovernor.Instance.GetStatusText();
+    }
+
     /// <summary>
     ///   Opens the options menu with main menu configuration settings.
     /// </summary>
@@ -362,6 +384,9 @@ public class OptionsMenu : Control
         // Performance
         cloudInterval.Selected = CloudIntervalToIndex(settings.CloudUpdateInterval);
         cloudResolution.Selected = CloudResolutionToIndex(settings.CloudResolution);
+        automaticQuality.Pressed = settings.AutomaticQuality;
+        targetFrameRate.Value = settings.TargetFrameRate;
+        targetFrameRate.Editable = settings.AutomaticQuality;
 
         // Misc
         playIntro.Pressed = settings.PlayIntroVideo;
@@ -865,6 +890,21 @@ public class OptionsMenu : Control
         UpdateResetSaveButtonState();
     }
 
+    private void OnAutomaticQualityToggled(bool pressed)
+    {
+        Settings.Instance.AutomaticQuality.Value = pressed;
+        targetFrameRate.Editable = pressed;
+
+        UpdateResetSaveButtonState();
+    }
+
+    private void OnTargetFrameRateValueChanged(float value)
+    {
+        Settings.Instance.TargetFrameRate.Value = (int)value;
+
+        UpdateResetSaveButtonState();
+    }
+
     // Misc Button Callbacks
     private void OnIntroToggled(bool pressed)
     {
@@ -0,0 +1,70 @@
+using System;
+
+/// <summary>
+///   Creates the Random objects used by the stage simulation
+/// </summary>
+/// <remarks>
+///   <para>
+///     Normally the created objects are seeded randomly. When a world seed is set (recording or replaying
+///     input) they are seeded from it instead so that the spawns and AI decisions repeat between runs.
+///   </para>
+/// </remarks>
+public static class SimulationRandom
+{
+    private static readonly object SeedLock = new object();
+
+    private static Random seedSource = new Random();
+
+    /// <summary>
+    ///   The current world seed, null if not running deterministically
+    /// </summary>
+    public static int? WorldSeed { get; private set; }
+
+    /// <summary>
+    ///   True when the simulation should behave the same between runs. Things that depend on timing, like the
+    ///   quality governor, should hold still when this is set.
+    /// </summary>
+    public static bool Deterministic => WorldSeed.HasValue;
+
+    /// <summary>
+    ///   Sets the world seed, or with null goes back to random seeds
+    /// </summary>
+    public static void SetWorldSeed(int? seed)
+    {
+        lock (SeedLock)
+        {
+            WorldSeed = seed;
+            seedSource = seed.HasValue ? new Random(seed.Value) : new Random();
+        }
+    }
+
+    /// <summary>
+    ///   Creates a new Random. This is only deterministic when called in the same order each run, so this must
+    ///   not be used from parallel tasks.
+    /// </summary>
+    public static Random Create()
+    {
+        lock (SeedLock)
+        {
+            return new Random(seedSource.Next());
+        }
+    }
+
+    /// <summary>
+    ///   Creates a Random for parallel code where the creation order isn't fixed
+    /// </summary>
+    /// <param name="frame">The frame number of the simulation</param>
+    /// <param name="index">Index of the object the random is for</param>
+    public static Random CreateFor(int frame, int index)
+    {
+        var seed = WorldSeed;
+
+        if (!seed.HasValue)
+            return new Random();
+
+        unchecked
+        {
+            return new Random((seed.Value * 397 ^ frame) * 397 ^ index);
+        }
+    }
+}
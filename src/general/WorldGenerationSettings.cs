@@ -3,4 +3,8 @@
 /// </summary>
 public class WorldGenerationSettings
 {
+    /// <summary>
+    ///   Seed for the random parts of the world and its evolution, null for a random seed
+    /// </summary>
+    public int? Seed { get; set; }
 }
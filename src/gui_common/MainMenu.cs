@@ -48,6 +48,21 @@ public class MainMenu : Node
     {
         RunMenuSetup();
 
+        if (CommandLineOptions.SoakMinutes > 0 && !IsReturningToMenu)
+        {
+            // The soak test lives outside the scenes so that it stays through the scene changes
+            GetTree().Root.CallDeferred("add_child", new SoakTest());
+            CallDeferred(nameof(OnMicrobeIntroEnded));
+            return;
+        }
+
+        // Replaying recorded input skips straight to the stage
+        if (CommandLineOptions.ReplayInputPath != null && !IsReturningToMenu)
+        {
+            CallDeferred(nameof(OnMicrobeIntroEnded));
+            return;
+        }
+
         // Start intro video
         if (Settings.Instance.PlayIntroVideo && !IsReturningToMenu)
         {
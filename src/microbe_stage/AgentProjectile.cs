@@ -1,27 +1,61 @@
 using Godot;
+using Newtonsoft.Json;
 
 /// <summary>
 ///   This is a shot agent projectile, does damage on hitting a cell of different species
 /// </summary>
 [JSONAlwaysDynamicType]
-public class AgentProjectile : RigidBody, ITimedLife
+public class AgentProjectile : RigidBody, ITimedLife, IPlanarPhysicsBody
 {
     public float TimeToLiveRemaining { get; set; }
     public float Amount { get; set; }
     public AgentProperties Properties { get; set; }
     public Node Emitter { get; set; }
 
+    [JsonIgnore]
+    public int PlanarBodyIndex { get; set; } = -1;
+
+    [JsonIgnore]
+    public float PlanarRadius => Constants.AGENT_PROJECTILE_RADIUS;
+
+    [JsonIgnore]
+    public Vector3 QueuedPlanarImpulse { get; set; }
+
     public void OnTimeOver()
     {
         Destroy();
     }
 
+    public override void _EnterTree()
+    {
+        PlanarPhysicsSystem.OnEntityEnteredTree(this);
+    }
+
+    public override void _ExitTree()
+    {
+        PlanarPhysicsSystem.OnEntityExitedTree(this);
+    }
+
     public override void _Ready()
     {
         AddCollisionExceptionWith(Emitter);
         Connect("body_entered", this, "OnBodyEntered");
     }
 
+    public bool PlanarCollidesWith(IPlanarPhysicsBody other)
+    {
+        return other != Emitter;
+    }
+
+    public void OnPlanarContactBegin(IPlanarPhysicsBody other)
+    {
+        OnBodyEntered((Node)other);
+    }
+
+    public void OnPlanarContactEnd(IPlanarPhysicsBody other)
+    {
+    }
+
     public void OnBodyEntered(Node body)
     {
         if (body is Microbe microbe)
@@ -0,0 +1,325 @@
+using System;
+using System.Diagnostics;
+using System.Numerics;
+using Vector2 = Godot.Vector2;
+
+/// <summary>
+///   The per cell loops of the compound clouds: diffusion, advection and writing the texture data. They work on
+///   buffers owned by the caller and only touch the given area of them, so different areas can be processed in
+///   parallel.
+/// </summary>
+/// <remarks>
+///   <para>
+///     There are two versions of each kernel. The pointer versions pin the buffers and walk them without bounds
+///     checks, handling all four compounds of a cell at once with Vector4 math. The checked versions are the
+///     plain array indexing loops the clouds used before, they are kept as the fallback
+///     (--safe-cloud-kernels) and as the reference the pointer versions are compared to by
+///     CloudKernelBenchmark. Both must give the same results.
+///   </para>
+///   <para>
+///     The density arrays are indexed [x, y] so the cell x, y is at x * size + y in memory.
+///   </para>
+/// </remarks>
+public static class CloudKernels
+{
+    /// <summary>
+    ///   When false the checked versions of the kernels are used
+    /// </summary>
+    public static bool UsePointerKernels { get; set; } = !CommandLineOptions.SafeCloudKernels;
+
+    /// <summary>
+    ///   Spreads the compounds in source to the neighbouring cells, writing the result to target. Neighbours
+    ///   outside the buffer wrap around to the other side.
+    /// </summary>
+    /// <param name="a">How much of a cell spreads to its neighbours</param>
+    public static void Diffuse(Vector4[,] source, Vector4[,] target, int size, int x0, int y0, int width,
+        int height, float a)
+    {
+        if (UsePointerKernels)
+        {
+            DiffusePointers(source, target, size, x0, y0, width, height, a);
+        }
+        else
+        {
+            DiffuseChecked(source, target, size, x0, y0, width, height, a);
+        }
+    }
+
+    /// <summary>
+    ///   Moves the compounds in source by the fluid velocity and adds them to target
+    /// </summary>
+    /// <param name="fluid">Where the velocities come from</param>
+    /// <param name="worldPosition">World position of the cell 0, 0</param>
+    /// <param name="resolution">World units per cell</param>
+    /// <param name="velocityScale">Multiplier for the fluid velocity</param>
+    /// <param name="clampToArea">
+    ///   If true the compounds can't move further than half a cell out of the processed area, this is what keeps
+    ///   the parallel updates from touching each other. If false the movement wraps around the buffer.
+    /// </param>
+    public static void Advect(Vector4[,] source, Vector4[,] target, int size, int x0, int y0, int width,
+        int height, float delta, FluidSystem fluid, Vector2 worldPosition, int resolution, float velocityScale,
+        bool clampToArea)
+    {
+        if (UsePointerKernels)
+        {
+            AdvectPointers(source, target, size, x0, y0, width, height, delta, fluid, worldPosition, resolution,
+                velocityScale, clampToArea);
+        }
+        else
+        {
+            AdvectChecked(source, target, size, x0, y0, width, height, delta, fluid, worldPosition, resolution,
+                velocityScale, clampToArea);
+        }
+    }
+
+    /// <summary>
+    ///   Writes the densities as half floats into RGBA half texture data, which is indexed row by row
+    /// </summary>
+    public static void WriteTexture(Vector4[,] density, byte[] textureData, int size, int x0, int y0, int width,
+        int height)
+    {
+        if (UsePointerKernels)
+        {
+            WriteTexturePointers(density, textureData, size, x0, y0, width, height);
+        }
+        else
+        {
+            WriteTextureChecked(density, textureData, size, x0, y0, width, height);
+        }
+    }
+
+    public static unsafe void DiffusePointers(Vector4[,] source, Vector4[,] target, int size, int x0, int y0,
+        int width, int height, float a)
+    {
+        float keep = 1 - a;
+        float spread = a / 4;
+
+        fixed (Vector4* sourceStart = source)
+        fixed (Vector4* targetStart = target)
+        {
+            for (int x = x0; x < x0 + width; ++x)
+            {
+                var column = sourceStart + x * size;
+                var left = sourceStart + (x == 0 ? size - 1 : x - 1) * size;
+                var right = sourceStart + (x == size - 1 ? 0 : x + 1) * size;
+                var output = targetStart + x * size;
+
+                for (int y = y0; y < y0 + height; ++y)
+                {
+                    int up = y == 0 ? size - 1 : y - 1;
+                    int down = y == size - 1 ? 0 : y + 1;
+
+                    output[y] = column[y] * keep + (column[up] + column[down] + left[y] + right[y]) * spread;
+                }
+            }
+        }
+    }
+
+    public static void DiffuseChecked(Vector4[,] source, Vector4[,] target, int size, int x0, int y0, int width,
+        int height, float a)
+    {
+        for (int x = x0; x < x0 + width; x++)
+        {
+            for (int y = y0; y < y0 + height; y++)
+            {
+                target[x, y] =
+                    source[x, y] * (1 - a) +
+                    (source[x, (y - 1 + size) % size] +
+                        source[x, (y + 1) % size] +
+                        source[(x - 1 + size) % size, y] +
+                        source[(x + 1) % size, y]) * (a / 4);
+            }
+        }
+    }
+
+    public static unsafe void AdvectPointers(Vector4[,] source, Vector4[,] target, int size, int x0, int y0,
+        int width, int height, float delta, FluidSystem fluid, Vector2 worldPosition, int resolution,
+        float velocityScale, bool clampToArea)
+    {
+        fixed (Vector4* sourceStart = source)
+        fixed (Vector4* targetStart = target)
+        {
+            for (int x = x0; x < x0 + width; ++x)
+            {
+                var column = sourceStart + x * size;
+
+                for (int y = y0; y < y0 + height; ++y)
+                {
+                    var amount = column[y];
+
+                    if (amount.LengthSquared() <= 1)
+                        continue;
+
+                    var velocity = fluid.VelocityAt(worldPosition + new Vector2(x, y) * resolution) * velocityScale;
+
+                    CalculateAdvectionTarget(x, y, velocity, delta, size, x0, y0, width, height, clampToArea,
+                        out int q0, out int q1, out int r0, out int r1,
+                        out float s1, out float s0, out float t1, out float t0);
+
+                    Debug.Assert(q0 >= 0 && q0 < size && q1 >= 0 && q1 < size && r0 >= 0 && r0 < size &&
+                        r1 >= 0 && r1 < size, "advection target is outside the cloud");
+
+                    var columnQ0 = targetStart + q0 * size;
+                    var columnQ1 = targetStart + q1 * size;
+
+                    columnQ0[r0] += amount * s0 * t0;
+                    columnQ0[r1] += amount * s0 * t1;
+                    columnQ1[r0] += amount * s1 * t0;
+                    columnQ1[r1] += amount * s1 * t1;
+                }
+            }
+        }
+    }
+
+    public static void AdvectChecked(Vector4[,] source, Vector4[,] target, int size, int x0, int y0, int width,
+        int height, float delta, FluidSystem fluid, Vector2 worldPosition, int resolution, float velocityScale,
+        bool clampToArea)
+    {
+        for (int x = x0; x < x0 + width; x++)
+        {
+            for (int y = y0; y < y0 + height; y++)
+            {
+                if (source[x, y].LengthSquared() > 1)
+                {
+                    var velocity = fluid.VelocityAt(worldPosition + new Vector2(x, y) * resolution) * velocityScale;
+
+                    CalculateAdvectionTarget(x, y, velocity, delta, size, x0, y0, width, height, clampToArea,
+                        out var q0, out var q1, out var r0, out var r1,
+                        out var s1, out var s0, out var t1, out var t0);
+
+                    target[q0, r0] += source[x, y] * s0 * t0;
+                    target[q0, r1] += source[x, y] * s0 * t1;
+                    target[q1, r0] += source[x, y] * s1 * t0;
+                    target[q1, r1] += source[x, y] * s1 * t1;
+                }
+            }
+        }
+    }
+
+    public static unsafe void WriteTexturePointers(Vector4[,] density, byte[] textureData, int size, int x0, int y0,
+        int width, int height)
+    {
+        if (textureData.Length < size * size * Constants.CLOUD_TEXTURE_BYTES_PER_PIXEL)
+            throw new ArgumentException("texture data is too small for the clouds", nameof(textureData));
+
+        fixed (Vector4* densityStart = density)
+        fixed (byte* textureStart = textureData)
+        {
+            // The halves are written in the machine byte order, which is little endian on all the platforms
+            // the game runs on, as the texture format expects
+            var halves = (ushort*)textureStart;
+
+            for (int y = y0; y < y0 + height; ++y)
+            {
+                var output = halves + (y * size + x0) * 4;
+                var input = densityStart + x0 * size + y;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    var pixel = *input;
+
+                    output[0] = MathUtils.FloatToHalf(pixel.X);
+                    output[1] = MathUtils.FloatToHalf(pixel.Y);
+                    output[2] = MathUtils.FloatToHalf(pixel.Z);
+                    output[3] = MathUtils.FloatToHalf(pixel.W);
+
+                    output += 4;
+                    input += size;
+                }
+            }
+        }
+    }
+
+    public static void WriteTextureChecked(Vector4[,] density, byte[] textureData, int size, int x0, int y0,
+        int width, int height)
+    {
+        for (int y = y0; y < y0 + height; y++)
+        {
+            int index = (y * size + x0) * Constants.CLOUD_TEXTURE_BYTES_PER_PIXEL;
+
+            for (int x = x0; x < x0 + width; x++)
+            {
+                var pixel = density[x, y];
+                WriteHalf(textureData, pixel.X, index);
+                WriteHalf(textureData, pixel.Y, index + 2);
+                WriteHalf(textureData, pixel.Z, index + 4);
+                WriteHalf(textureData, pixel.W, index + 6);
+                index += Constants.CLOUD_TEXTURE_BYTES_PER_PIXEL;
+            }
+        }
+    }
+
+    /// <summary>
+    ///   Finds the cells the compounds of the cell x, y move to and how much goes to each. The cells are always
+    ///   inside the buffer, which the pointer kernel relies on as it doesn't check the indices.
+    /// </summary>
+    private static void CalculateAdvectionTarget(int x, int y, Vector2 velocity, float delta, int size, int x0,
+        int y0, int width, int height, bool clampToArea, out int q0, out int q1, out int r0, out int r1,
+        out float s1, out float s0, out float t1, out float t0)
+    {
+        // Limited so that huge velocities can't overflow the indices, this also turns NaN into a valid value
+        float dx = x + (delta * velocity.x).Clamp(-size, size);
+        float dy = y + (delta * velocity.y).Clamp(-size, size);
+
+        if (clampToArea)
+        {
+            // Areas at the edge of the buffer are also limited by the buffer
+            dx = dx.Clamp(Math.Max(x0 - 0.5f, 0), Math.Min(x0 + width + 0.5f, size - 1));
+            dy = dy.Clamp(Math.Max(y0 - 0.5f, 0), Math.Min(y0 + height + 0.5f, size - 1));
+        }
+
+        CalculateMovementFactors(dx, dy, out q0, out q1, out r0, out r1, out s1, out s0, out t1, out t0);
+
+        if (clampToArea)
+        {
+            // At the last cell nothing goes to the next one, this only keeps the index valid
+            q1 = Math.Min(q1, size - 1);
+            r1 = Math.Min(r1, size - 1);
+        }
+        else
+        {
+            q0 = WrapIndex(q0, size);
+            q1 = WrapIndex(q1, size);
+            r0 = WrapIndex(r0, size);
+            r1 = WrapIndex(r1, size);
+        }
+    }
+
+    /// <summary>
+    ///   Wraps a cell index to be inside the buffer, also works with indices more than size below 0
+    /// </summary>
+    private static int WrapIndex(int index, int size)
+    {
+        int result = index % size;
+        return result < 0 ? result + size : result;
+    }
+
+    /// <summary>
+    ///   Calculates the multipliers for the old density to move to new locations
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     The name might not be super accurate as I just picked something to reduce code duplication
+    ///   </para>
+    /// </remarks>
+    private static void CalculateMovementFactors(float dx, float dy, out int q0, out int q1, out int r0, out int r1,
+        out float s1, out float s0, out float t1, out float t0)
+    {
+        q0 = (int)Math.Floor(dx);
+        q1 = q0 + 1;
+        r0 = (int)Math.Floor(dy);
+        r1 = r0 + 1;
+
+        s1 = Math.Abs(dx - q0);
+        s0 = 1.0f - s1;
+        t1 = Math.Abs(dy - r0);
+        t0 = 1.0f - t1;
+    }
+
+    private static void WriteHalf(byte[] textureData, float value, int index)
+    {
+        ushort half = MathUtils.FloatToHalf(value);
+        textureData[index] = (byte)half;
+        textureData[index + 1] = (byte)(half >> 8);
+    }
+}
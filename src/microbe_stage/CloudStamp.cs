@@ -0,0 +1,90 @@
+using System;
+using Godot;
+
+/// <summary>
+///   A brush shape for adding compounds to the clouds. The weights are calculated once so that adding a compound
+///   with a stamp is just a pass over the covered cells.
+/// </summary>
+public class CloudStamp
+{
+    /// <summary>
+    ///   The shape that cloud spawns have always used, the cell and its four neighbours
+    /// </summary>
+    public static readonly CloudStamp Spawn = new CloudStamp(1, Falloff.Flat);
+
+    /// <summary>
+    ///   A single cell, for venting and ejecting compounds
+    /// </summary>
+    public static readonly CloudStamp Point = new CloudStamp(0, Falloff.Flat);
+
+    public CloudStamp(int radius, Falloff falloff)
+    {
+        if (radius < 0)
+            throw new ArgumentException("radius can't be negative", nameof(radius));
+
+        Radius = radius;
+        Width = radius * 2 + 1;
+        Weights = new float[Width * Width];
+
+        for (int y = -radius; y <= radius; ++y)
+        {
+            for (int x = -radius; x <= radius; ++x)
+            {
+                float distance = Mathf.Sqrt(x * x + y * y);
+
+                if (distance > radius)
+                    continue;
+
+                float weight;
+
+                switch (falloff)
+                {
+                    case Falloff.Flat:
+                        weight = 1.0f;
+                        break;
+                    case Falloff.Linear:
+                        weight = 1.0f - distance / (radius + 1);
+                        break;
+                    case Falloff.Smooth:
+                        float t = distance / (radius + 1);
+                        weight = 1.0f - t * t * (3.0f - 2.0f * t);
+                        break;
+                    default:
+                        throw new ArgumentOutOfRangeException(nameof(falloff), falloff, null);
+                }
+
+                Weights[(y + radius) * Width + x + radius] = weight;
+            }
+        }
+    }
+
+    public enum Falloff
+    {
+        /// <summary>
+        ///   Every cell in the radius gets the full amount
+        /// </summary>
+        Flat,
+
+        /// <summary>
+        ///   The amount goes down linearly towards the edge
+        /// </summary>
+        Linear,
+
+        /// <summary>
+        ///   The amount goes down along a smoothstep curve
+        /// </summary>
+        Smooth,
+    }
+
+    /// <summary>
+    ///   Radius in cloud cells
+    /// </summary>
+    public int Radius { get; }
+
+    public int Width { get; }
+
+    /// <summary>
+    ///   Multipliers of the stamped amount, row by row. The centre cell has the weight 1.
+    /// </summary>
+    public float[] Weights { get; }
+}
@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Numerics;
 using System.Threading.Tasks;
 using Godot;
@@ -7,7 +8,7 @@ using Newtonsoft.Json;
 using Vector2 = Godot.Vector2;
 using Vector3 = Godot.Vector3;
 
-public class CompoundCloudPlane : CSGMesh, ISaveApplyable
+public class CompoundCloudPlane : CSGMesh, ISaveApplyable, IMemoryReporter
 {
     /// <summary>
     ///   The current densities of compounds. This uses custom writing so this is ignored
@@ -24,6 +25,17 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
     // JSON file and use it instead.
     private const float VISCOSITY = 0.0525f;
 
+    /// <summary>
+    ///   Stamps added this frame, written together by ApplyQueuedStamps
+    /// </summary>
+    private readonly List<QueuedStamp> queuedStamps = new List<QueuedStamp>();
+
+    /// <summary>
+    ///   Raw density data in half-float RGBA format that is uploaded to the texture. Normalisation and colouring
+    ///   is done by the shader so the CPU only needs to do the format conversion per cell.
+    /// </summary>
+    private byte[] textureData;
+
     private Image image;
     private ImageTexture texture;
     private FluidSystem fluidSystem;
@@ -45,8 +57,8 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
         if (IsLoadedFromSave)
             return;
 
-        Size = Settings.Instance.CloudSimulationWidth;
-        Resolution = Settings.Instance.CloudResolution;
+        Resolution = QualityGovernor.Instance.CloudResolution;
+        Size = Constants.CLOUD_X_EXTENT / Resolution;
         CreateDensityTexture();
 
         Density = new Vector4[Size, Size];
@@ -315,8 +327,6 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
     /// </summary>
     public void QueueUpdateTextureImage(List<Task> queue)
     {
-        image.Lock();
-
         for (int i = 0; i < Constants.CLOUD_SQUARES_PER_SIDE; i++)
         {
             for (int j = 0; j < Constants.CLOUD_SQUARES_PER_SIDE; j++)
@@ -334,8 +344,10 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
 
     public void UpdateTexture()
     {
-        image.Unlock();
-        texture.CreateFromImage(image, (uint)Texture.FlagsEnum.Filter | (uint)Texture.FlagsEnum.Repeat);
+        image.CreateFromData(Size, Size, false, Image.Format.Rgbah, textureData);
+
+        // SetData reuses the existing texture instead of allocating a new one each update
+        texture.SetData(image);
     }
 
     public bool HandlesCompound(Compound compound)
@@ -349,6 +361,83 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
         return false;
     }
 
+    /// <summary>
+    ///   Queues adding some compound around a world position with a stamp. The compound must be handled by this
+    ///   cloud.
+    /// </summary>
+    public void QueueStamp(Compound compound, float amount, Vector3 worldPosition, CloudStamp stamp)
+    {
+        queuedStamps.Add(new QueuedStamp(GetCompoundIndex(compound), amount, worldPosition, stamp));
+    }
+
+    /// <summary>
+    ///   Writes the queued stamps. The parts of the stamps that are outside the cloud area are dropped.
+    /// </summary>
+    public void ApplyQueuedStamps()
+    {
+        if (queuedStamps.Count < 1)
+            return;
+
+        int offsetX = position.x * Size / Constants.CLOUD_SQUARES_PER_SIDE;
+        int offsetY = position.y * Size / Constants.CLOUD_SQUARES_PER_SIDE;
+
+        foreach (var queued in queuedStamps)
+        {
+            var topLeftRelative = queued.Position - Translation;
+
+            // Cell coordinates before the wrap around that ConvertToCloudLocal does, for the edge checks
+            int centerX = (int)Math.Floor((topLeftRelative.x + Constants.CLOUD_WIDTH) / Resolution);
+            int centerY = (int)Math.Floor((topLeftRelative.z + Constants.CLOUD_HEIGHT) / Resolution);
+
+            var stamp = queued.Stamp;
+            int radius = stamp.Radius;
+
+            for (int stampY = 0; stampY < stamp.Width; ++stampY)
+            {
+                int unwrappedY = centerY + stampY - radius;
+
+                if (unwrappedY < 0 || unwrappedY >= Size)
+                    continue;
+
+                int y = (unwrappedY + offsetY) % Size;
+
+                for (int stampX = 0; stampX < stamp.Width; ++stampX)
+                {
+                    int unwrappedX = centerX + stampX - radius;
+
+                    if (unwrappedX < 0 || unwrappedX >= Size)
+                        continue;
+
+                    float weight = stamp.Weights[stampY * stamp.Width + stampX];
+
+                    if (weight <= 0)
+                        continue;
+
+                    int x = (unwrappedX + offsetX) % Size;
+                    float value = queued.Amount * weight;
+
+                    switch (queued.Channel)
+                    {
+                        case 0:
+                            Density[x, y].X += value;
+                            break;
+                        case 1:
+                            Density[x, y].Y += value;
+                            break;
+                        case 2:
+                            Density[x, y].Z += value;
+                            break;
+                        case 3:
+                            Density[x, y].W += value;
+                            break;
+                    }
+                }
+            }
+        }
+
+        queuedStamps.Clear();
+    }
+
     /// <summary>
     ///   Adds some compound in cloud local coordinates
     /// </summary>
@@ -508,6 +597,8 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
 
     public void ClearContents()
     {
+        queuedStamps.Clear();
+
         for (int x = 0; x < Size; ++x)
         {
             for (int y = 0; y < Size; ++y)
@@ -518,6 +609,80 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
         }
     }
 
+    /// <summary>
+    ///   Writes the densities for a patch snapshot
+    /// </summary>
+    public void WriteSnapshot(BinaryWriter writer)
+    {
+        writer.Write(Size);
+
+        for (int x = 0; x < Size; ++x)
+        {
+            for (int y = 0; y < Size; ++y)
+            {
+                var cell = Density[x, y];
+                writer.Write(cell.X);
+                writer.Write(cell.Y);
+                writer.Write(cell.Z);
+                writer.Write(cell.W);
+            }
+        }
+    }
+
+    /// <summary>
+    ///   Reads densities written by WriteSnapshot
+    /// </summary>
+    /// <returns>False if the snapshot was made with a different cloud resolution</returns>
+    public bool ReadSnapshot(BinaryReader reader)
+    {
+        if (reader.ReadInt32() != Size)
+            return false;
+
+        for (int x = 0; x < Size; ++x)
+        {
+            for (int y = 0; y < Size; ++y)
+            {
+                var cell = new Vector4(reader.ReadSingle(), reader.ReadSingle(), reader.ReadSingle(),
+                    reader.ReadSingle());
+                Density[x, y] = cell;
+                OldDensity[x, y] = cell;
+            }
+        }
+
+        return true;
+    }
+
+    public int CountActiveCells()
+    {
+        int count = 0;
+
+        for (int x = 0; x < Size; ++x)
+        {
+            for (int y = 0; y < Size; ++y)
+            {
+                var cell = Density[x, y];
+
+                if (cell.X + cell.Y + cell.Z + cell.W > Constants.CLOUD_ACTIVE_CELL_THRESHOLD)
+                    ++count;
+            }
+        }
+
+        return count;
+    }
+
+    public void ReportMemory(MemoryReport report)
+    {
+        if (Density == null || textureData == null)
+            return;
+
+        // Vector4 is 4 floats
+        report.Add("Clouds", "density arrays", (Density.LongLength + OldDensity.LongLength) * 16, 2);
+        report.Add("Clouds", "texture upload buffers", textureData.LongLength);
+
+        // The image and the texture have their own copies of the data in the engine
+        report.Add("Clouds", "images and textures", textureData.LongLength * 2, 2);
+    }
+
     public void ApplyPropertiesFromSave(CompoundCloudPlane cloud)
     {
         Density = cloud.Density;
@@ -548,132 +713,39 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
         IsLoadedFromSave = true;
     }
 
-    /// <summary>
-    ///   Calculates the multipliers for the old density to move to new locations
-    /// </summary>
-    /// <remarks>
-    ///   <para>
-    ///     The name might not be super accurate as I just picked something to reduce code duplication
-    ///   </para>
-    /// </remarks>
-    private static void CalculateMovementFactors(float dx, float dy, out int q0, out int q1, out int r0, out int r1,
-        out float s1, out float s0, out float t1, out float t0)
-    {
-        q0 = (int)Math.Floor(dx);
-        q1 = q0 + 1;
-        r0 = (int)Math.Floor(dy);
-        r1 = r0 + 1;
-
-        s1 = Math.Abs(dx - q0);
-        s0 = 1.0f - s1;
-        t1 = Math.Abs(dy - r0);
-        t0 = 1.0f - t1;
-    }
-
     private void PartialDiffuseCenter(int x0, int y0, int width, int height, float delta)
     {
-        float a = delta * Constants.CLOUD_DIFFUSION_RATE;
-
-        for (int x = x0; x < x0 + width; x++)
-        {
-            for (int y = y0; y < y0 + height; y++)
-            {
-                int adjacentClouds = 4;
-                OldDensity[x, y] =
-                    Density[x, y] * (1 - a) +
-                    (Density[x, y - 1] + Density[x, y + 1] + Density[x - 1, y] + Density[x + 1, y])
-                    * (a / adjacentClouds);
-            }
-        }
+        CloudKernels.Diffuse(Density, OldDensity, Size, x0, y0, width, height,
+            delta * Constants.CLOUD_DIFFUSION_RATE);
     }
 
     private void PartialDiffuseEdges(int x0, int y0, int width, int height, float delta)
     {
-        float a = delta * Constants.CLOUD_DIFFUSION_RATE;
-
-        for (int x = x0; x < x0 + width; x++)
-        {
-            for (int y = y0; y < y0 + height; y++)
-            {
-                int adjacentClouds = 4;
-                OldDensity[x, y] =
-                    Density[x, y] * (1 - a) +
-                    (Density[x, (y - 1 + Size) % Size] +
-                        Density[x, (y + 1) % Size] +
-                        Density[(x - 1 + Size) % Size, y] +
-                        Density[(x + 1) % Size, y]) * (a / adjacentClouds);
-            }
-        }
+        // The kernel wraps around the edges of the buffer
+        CloudKernels.Diffuse(Density, OldDensity, Size, x0, y0, width, height,
+            delta * Constants.CLOUD_DIFFUSION_RATE);
     }
 
     private void PartialAdvectCenter(int x0, int y0, int width, int height, float delta, Vector2 pos)
     {
-        for (int x = x0; x < x0 + width; x++)
-        {
-            for (int y = y0; y < y0 + height; y++)
-            {
-                if (OldDensity[x, y].LengthSquared() > 1)
-                {
-                    var velocity = fluidSystem.VelocityAt(
-                        pos + (new Vector2(x, y) * Resolution)) * VISCOSITY;
-
-                    // This is ran in parallel, this may not touch the other compound clouds
-                    float dx = x + (delta * velocity.x);
-                    float dy = y + (delta * velocity.y);
-
-                    // So this is clamped to not go to the other clouds
-                    dx = dx.Clamp(x0 - 0.5f, x0 + width + 0.5f);
-                    dy = dy.Clamp(y0 - 0.5f, y0 + height + 0.5f);
-
-                    CalculateMovementFactors(dx, dy, out var q0, out var q1, out var r0, out var r1,
-                        out var s1, out var s0, out var t1, out var t0);
-
-                    Density[q0, r0] += OldDensity[x, y] * s0 * t0;
-                    Density[q0, r1] += OldDensity[x, y] * s0 * t1;
-                    Density[q1, r0] += OldDensity[x, y] * s1 * t0;
-                    Density[q1, r1] += OldDensity[x, y] * s1 * t1;
-                }
-            }
-        }
+        // This is ran in parallel, so the movement is clamped to not touch the other compound clouds
+        CloudKernels.Advect(OldDensity, Density, Size, x0, y0, width, height, delta, fluidSystem, pos, Resolution,
+            VISCOSITY, true);
     }
 
     private void PartialAdvectEdges(int x0, int y0, int width, int height, float delta, Vector2 pos)
     {
-        for (int x = x0; x < x0 + width; x++)
-        {
-            for (int y = y0; y < y0 + height; y++)
-            {
-                if (OldDensity[x, y].LengthSquared() > 1)
-                {
-                    var velocity = fluidSystem.VelocityAt(
-                        pos + (new Vector2(x, y) * Resolution)) * VISCOSITY;
-
-                    // This is ran in parallel, this may not touch the other compound clouds
-                    float dx = x + (delta * velocity.x);
-                    float dy = y + (delta * velocity.y);
-
-                    CalculateMovementFactors(dx, dy, out var q0, out var q1, out var r0, out var r1,
-                        out var s1, out var s0, out var t1, out var t0);
-
-                    Density[(q0 + Size) % Size, (r0 + Size) % Size] += OldDensity[x, y] * s0 * t0;
-                    Density[(q0 + Size) % Size, (r1 + Size) % Size] += OldDensity[x, y] * s0 * t1;
-                    Density[(q1 + Size) % Size, (r0 + Size) % Size] += OldDensity[x, y] * s1 * t0;
-                    Density[(q1 + Size) % Size, (r1 + Size) % Size] += OldDensity[x, y] * s1 * t1;
-                }
-            }
-        }
+        CloudKernels.Advect(OldDensity, Density, Size, x0, y0, width, height, delta, fluidSystem, pos, Resolution,
+            VISCOSITY, false);
     }
 
+    /// <summary>
+    ///   Writes the raw densities of a part of the cloud into the texture data buffer.
+    ///   The tiles this is called with don't overlap so this is safe to run in parallel.
+    /// </summary>
     private void PartialUpdateTextureImage(int x0, int y0, int width, int height)
     {
-        for (int x = x0; x < x0 + width; x++)
-        {
-            for (int y = y0; y < y0 + height; y++)
-            {
-                var pixel = Density[x, y] * (1 / Constants.CLOUD_MAX_INTENSITY_SHOWN);
-                image.SetPixel(x, y, new Color(pixel.X, pixel.Y, pixel.Z, pixel.W));
-            }
-        }
+        CloudKernels.WriteTexture(Density, textureData, Size, x0, y0, width, height);
     }
 
     private void PartialClearDensity(int x0, int y0, int width, int height)
@@ -722,8 +794,10 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
 
     private void CreateDensityTexture()
     {
+        textureData = new byte[Size * Size * Constants.CLOUD_TEXTURE_BYTES_PER_PIXEL];
+
         image = new Image();
-        image.Create(Size, Size, false, Image.Format.Rgba8);
+        image.Create(Size, Size, false, Image.Format.Rgbah);
         texture = new ImageTexture();
         texture.CreateFromImage(image, (uint)Texture.FlagsEnum.Filter | (uint)Texture.FlagsEnum.Repeat);
 
@@ -737,4 +811,20 @@ public class CompoundCloudPlane : CSGMesh, ISaveApplyable
         material.SetShaderParam("UVoffset", new Vector2(position.x / (float)Constants.CLOUD_SQUARES_PER_SIDE,
             position.y / (float)Constants.CLOUD_SQUARES_PER_SIDE));
     }
+
+    private struct QueuedStamp
+    {
+        public readonly int Channel;
+        public readonly float Amount;
+        public readonly Vector3 Position;
+        public readonly CloudStamp Stamp;
+
+        public QueuedStamp(int channel, float amount, Vector3 position, CloudStamp stamp)
+        {
+            Channel = channel;
+            Amount = amount;
+            Position = position;
+            Stamp = stamp;
+        }
+    }
 }
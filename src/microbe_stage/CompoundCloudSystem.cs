@@ -1,15 +1,24 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Diagnostics.CodeAnalysis;
+using System.IO;
 using System.Threading.Tasks;
 using Godot;
+using ICSharpCode.SharpZipLib.GZip;
 using Newtonsoft.Json;
 
 /// <summary>
 ///   Manages spawning and processing compound clouds
 /// </summary>
-public class CompoundCloudSystem : Node
+public class CompoundCloudSystem : Node, IMemoryReporter
 {
+    private const int SNAPSHOT_VERSION = 1;
+
+    private readonly Stopwatch stopwatch = new Stopwatch();
+
+    private readonly CompoundGradientField gradientField = new CompoundGradientField();
+
     [JsonProperty]
     private int neededCloudsAtOnePosition;
 
@@ -31,12 +40,23 @@ public class CompoundCloudSystem : Node
     [JsonProperty]
     private float elapsed;
 
+    private float timeUntilGradientUpdate;
+
     /// <summary>
     ///   The cloud resolution of the first cloud
     /// </summary>
     [JsonIgnore]
     public int Resolution => clouds[0].Resolution;
 
+    [JsonIgnore]
+    public int CloudPlaneCount => clouds.Count;
+
+    /// <summary>
+    ///   Coarse compound amounts for the AI, updated every Constants.COMPOUND_GRADIENT_UPDATE_INTERVAL
+    /// </summary>
+    [JsonIgnore]
+    public CompoundGradientField GradientField => gradientField;
+
     public override void _Ready()
     {
         cloudScene = GD.Load<PackedScene>("res://src/microbe_stage/CompoundCloudPlane.tscn");
@@ -46,13 +66,31 @@ public class CompoundCloudSystem : Node
     {
         elapsed += delta;
 
+        stopwatch.Restart();
+        var allocationStart = AllocationTracker.Instance.BeginMeasure();
+
+        foreach (var cloud in clouds)
+            cloud.ApplyQueuedStamps();
+
         // Limit the rate at which the clouds are processed as they
         // are a major performance sink
-        if (elapsed >= Settings.Instance.CloudUpdateInterval)
+        if (elapsed >= QualityGovernor.Instance.CloudUpdateInterval)
         {
             UpdateCloudContents(elapsed);
             elapsed = 0.0f;
         }
+
+        timeUntilGradientUpdate -= delta;
+
+        if (timeUntilGradientUpdate <= 0)
+        {
+            timeUntilGradientUpdate = Constants.COMPOUND_GRADIENT_UPDATE_INTERVAL;
+            gradientField.Update(clouds, allCloudCompounds);
+        }
+
+        QualityGovernor.Instance.ReportSystemTime(QualityGovernor.GovernedSystem.Clouds,
+            (float)stopwatch.Elapsed.TotalMilliseconds);
+        AllocationTracker.Instance.EndMeasure(QualityGovernor.GovernedSystem.Clouds, allocationStart);
     }
 
     /// <summary>
@@ -134,6 +172,26 @@ public class CompoundCloudSystem : Node
         return false;
     }
 
+    /// <summary>
+    ///   Adds compound around a position with a stamp. The stamps added in a frame are written together at the
+    ///   start of the next cloud update, so this is cheaper than calling AddCloud for each cell.
+    /// </summary>
+    /// <param name="compound">The compound to add</param>
+    /// <param name="amount">Amount for the cells with a full weight in the stamp</param>
+    /// <param name="worldPosition">Centre of the stamp</param>
+    /// <param name="stamp">Which cells get the compound</param>
+    public void AddCloudStamp(Compound compound, float amount, Vector3 worldPosition, CloudStamp stamp)
+    {
+        foreach (var cloud in clouds)
+        {
+            if (cloud.HandlesCompound(compound))
+            {
+                cloud.QueueStamp(compound, amount, worldPosition, stamp);
+                return;
+            }
+        }
+    }
+
     /// <summary>
     ///   Takes compound at world position
     /// </summary>
@@ -186,7 +244,15 @@ public class CompoundCloudSystem : Node
     public Dictionary<Compound, float> GetAllAvailableAt(Vector3 worldPosition)
     {
         var result = new Dictionary<Compound, float>();
+        GetAllAvailableAt(worldPosition, result);
+        return result;
+    }
 
+    /// <summary>
+    ///   Adds the amounts of all compounds at position to result, for callers that reuse the dictionary
+    /// </summary>
+    public void GetAllAvailableAt(Vector3 worldPosition, Dictionary<Compound, float> result)
+    {
         foreach (var cloud in clouds)
         {
             int x, y;
@@ -195,8 +261,6 @@ public class CompoundCloudSystem : Node
                 cloud.GetCompoundsAt(x, y, result);
             }
         }
-
-        return result;
     }
 
     /// <summary>
@@ -374,6 +438,61 @@ public class CompoundCloudSystem : Node
             cloud.ClearContents();
     }
 
+    /// <summary>
+    ///   Creates a compressed copy of the cloud contents, for keeping the clouds of a patch the player left
+    /// </summary>
+    public byte[] CreateSnapshot()
+    {
+        using (var memory = new MemoryStream())
+        {
+            using (var writer = new BinaryWriter(new GZipOutputStream(memory)))
+            {
+                writer.Write(SNAPSHOT_VERSION);
+                writer.Write(cloudGridCenter.x);
+                writer.Write(cloudGridCenter.z);
+                writer.Write(clouds.Count);
+
+                foreach (var cloud in clouds)
+                    cloud.WriteSnapshot(writer);
+            }
+
+            return memory.ToArray();
+        }
+    }
+
+    /// <summary>
+    ///   Replaces the cloud contents with a snapshot from CreateSnapshot
+    /// </summary>
+    /// <returns>
+    ///   False if the snapshot doesn't match the current clouds, for example because the cloud resolution changed.
+    ///   The clouds are then empty.
+    /// </returns>
+    public bool ApplySnapshot(byte[] snapshot)
+    {
+        using (var reader = new BinaryReader(new GZipInputStream(new MemoryStream(snapshot))))
+        {
+            if (reader.ReadInt32() != SNAPSHOT_VERSION)
+                return false;
+
+            cloudGridCenter = new Vector3(reader.ReadSingle(), 0, reader.ReadSingle());
+            PositionClouds();
+
+            if (reader.ReadInt32() != clouds.Count)
+                return false;
+
+            foreach (var cloud in clouds)
+            {
+                if (!cloud.ReadSnapshot(reader))
+                {
+                    EmptyAllClouds();
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
     /// <summary>
     ///   Used from the stage to update the player position to reposition the clouds
     /// </summary>
@@ -393,6 +512,24 @@ public class CompoundCloudSystem : Node
         }
     }
 
+    /// <summary>
+    ///   Counts the cells with compounds in one of the cloud planes. The planes can be counted one at a time as
+    ///   going through all of them at once is slow.
+    /// </summary>
+    /// <param name="planeIndex">The plane to count, from 0 to CloudPlaneCount - 1</param>
+    public int CountActiveCells(int planeIndex)
+    {
+        return clouds[planeIndex].CountActiveCells();
+    }
+
+    public void ReportMemory(MemoryReport report)
+    {
+        foreach (var cloud in clouds)
+            cloud.ReportMemory(report);
+
+        report.Add("Clouds", "gradient field", gradientField.Bytes);
+    }
+
     public void ApplyPropertiesFromSave(CompoundCloudSystem compoundCloudSystem)
     {
         cloudGridCenter = compoundCloudSystem.cloudGridCenter;
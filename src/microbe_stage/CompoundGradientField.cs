@@ -0,0 +1,180 @@
+using System.Collections.Generic;
+using Godot;
+
+/// <summary>
+///   A coarse grid of the compound amounts in the clouds, so that the AI can find where compounds are with a
+///   constant cost no matter the cloud resolution
+/// </summary>
+/// <remarks>
+///   <para>
+///     This is rebuilt at a low rate by CompoundCloudSystem. Each coarse cell is sampled at a fixed number of
+///     points instead of summing all the cloud cells in it, so the update cost doesn't depend on the cloud
+///     resolution either. The new values are written to a second buffer that is then swapped in.
+///   </para>
+/// </remarks>
+public class CompoundGradientField
+{
+    private readonly List<Compound> compounds = new List<Compound>();
+
+    /// <summary>
+    ///   Amounts of compound c at the cell x, y are at (c * CellsPerSide + y) * CellsPerSide + x
+    /// </summary>
+    private float[] amounts;
+    private float[] nextAmounts;
+
+    private Vector3 origin;
+
+    public CompoundGradientField()
+    {
+        CellsPerSide = Constants.CLOUD_X_EXTENT / Constants.COMPOUND_GRADIENT_CELL_SIZE;
+    }
+
+    public int CellsPerSide { get; }
+
+    public bool HasData => amounts != null;
+
+    /// <summary>
+    ///   Size of the amount buffers in bytes
+    /// </summary>
+    public long Bytes => ((amounts?.LongLength ?? 0) + (nextAmounts?.LongLength ?? 0)) * sizeof(float);
+
+    /// <summary>
+    ///   Samples the clouds again
+    /// </summary>
+    /// <param name="clouds">The clouds, which all cover the same area</param>
+    /// <param name="allCloudCompounds">All of the compounds the clouds can contain</param>
+    public void Update(List<CompoundCloudPlane> clouds, List<Compound> allCloudCompounds)
+    {
+        if (clouds.Count < 1 || clouds[0].Density == null)
+            return;
+
+        if (compounds.Count != allCloudCompounds.Count)
+        {
+            compounds.Clear();
+            compounds.AddRange(allCloudCompounds);
+            amounts = null;
+        }
+
+        int cellCount = CellsPerSide * CellsPerSide;
+
+        if (nextAmounts == null || nextAmounts.Length != cellCount * compounds.Count)
+            nextAmounts = new float[cellCount * compounds.Count];
+
+        origin = clouds[0].Translation - new Vector3(Constants.CLOUD_WIDTH, 0, Constants.CLOUD_HEIGHT);
+
+        foreach (var cloud in clouds)
+            SampleCloud(cloud);
+
+        var previous = amounts;
+        amounts = nextAmounts;
+        nextAmounts = previous;
+    }
+
+    /// <summary>
+    ///   The average amount of a compound around a position
+    /// </summary>
+    public float GetAmount(Compound compound, Vector3 position)
+    {
+        var currentAmounts = amounts;
+        int index = compounds.IndexOf(compound);
+
+        if (currentAmounts == null || index < 0 || !ToCell(position, out int x, out int y))
+            return 0;
+
+        return currentAmounts[(index * CellsPerSide + y) * CellsPerSide + x];
+    }
+
+    /// <summary>
+    ///   Direction towards more of the compounds that are useful for the bag. The length tells how steep the
+    ///   change is.
+    /// </summary>
+    public Vector3 GetGradient(Vector3 position, CompoundBag usefulFor)
+    {
+        var currentAmounts = amounts;
+
+        if (currentAmounts == null || !ToCell(position, out int x, out int y))
+            return Vector3.Zero;
+
+        int left = Mathf.Max(0, x - 1);
+        int right = Mathf.Min(CellsPerSide - 1, x + 1);
+        int up = Mathf.Max(0, y - 1);
+        int down = Mathf.Min(CellsPerSide - 1, y + 1);
+
+        var gradient = Vector3.Zero;
+
+        for (int i = 0; i < compounds.Count; ++i)
+        {
+            if (!usefulFor.IsUseful(compounds[i]))
+                continue;
+
+            int start = i * CellsPerSide * CellsPerSide;
+
+            gradient.x += currentAmounts[start + y * CellsPerSide + right] -
+                currentAmounts[start + y * CellsPerSide + left];
+            gradient.z += currentAmounts[start + down * CellsPerSide + x] -
+                currentAmounts[start + up * CellsPerSide + x];
+        }
+
+        return gradient;
+    }
+
+    private bool ToCell(Vector3 position, out int x, out int y)
+    {
+        var relative = position - origin;
+
+        x = Mathf.FloorToInt(relative.x / Constants.COMPOUND_GRADIENT_CELL_SIZE);
+        y = Mathf.FloorToInt(relative.z / Constants.COMPOUND_GRADIENT_CELL_SIZE);
+
+        return x >= 0 && y >= 0 && x < CellsPerSide && y < CellsPerSide;
+    }
+
+    private void SampleCloud(CompoundCloudPlane cloud)
+    {
+        // Where each of the cloud channels goes in the field
+        var channels = new int[Constants.CLOUDS_IN_ONE];
+
+        for (int i = 0; i < channels.Length; ++i)
+            channels[i] = cloud.Compounds[i] != null ? compounds.IndexOf(cloud.Compounds[i]) : -1;
+
+        int samples = Constants.COMPOUND_GRADIENT_SAMPLES;
+        float step = Constants.COMPOUND_GRADIENT_CELL_SIZE / (float)samples;
+        float weight = 1.0f / (samples * samples);
+        int cellCount = CellsPerSide * CellsPerSide;
+
+        for (int y = 0; y < CellsPerSide; ++y)
+        {
+            for (int x = 0; x < CellsPerSide; ++x)
+            {
+                var sum = System.Numerics.Vector4.Zero;
+
+                for (int sampleY = 0; sampleY < samples; ++sampleY)
+                {
+                    for (int sampleX = 0; sampleX < samples; ++sampleX)
+                    {
+                        var position = origin + new Vector3(
+                            x * Constants.COMPOUND_GRADIENT_CELL_SIZE + (sampleX + 0.5f) * step, 0,
+                            y * Constants.COMPOUND_GRADIENT_CELL_SIZE + (sampleY + 0.5f) * step);
+
+                        cloud.ConvertToCloudLocal(position, out int cloudX, out int cloudY);
+
+                        if (cloudX >= 0 && cloudY >= 0 && cloudX < cloud.Size && cloudY < cloud.Size)
+                            sum += cloud.Density[cloudX, cloudY];
+                    }
+                }
+
+                int cell = y * CellsPerSide + x;
+
+                SetChannel(channels[0], cellCount, cell, sum.X * weight);
+                SetChannel(channels[1], cellCount, cell, sum.Y * weight);
+                SetChannel(channels[2], cellCount, cell, sum.Z * weight);
+                SetChannel(channels[3], cellCount, cell, sum.W * weight);
+            }
+        }
+    }
+
+    private void SetChannel(int compoundIndex, int cellCount, int cell, float value)
+    {
+        if (compoundIndex >= 0)
+            nextAmounts[compoundIndex * cellCount + cell] = value;
+    }
+}
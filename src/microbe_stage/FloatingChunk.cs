@@ -8,7 +8,7 @@ using Newtonsoft.Json;
 /// </summary>
 [JsonObject(IsReference = true)]
 [JSONAlwaysDynamicType]
-public class FloatingChunk : RigidBody, ISpawned
+public class FloatingChunk : RigidBody, ISpawned, IPlanarPhysicsBody, ISimulationTiered
 {
     [Export]
     public PackedScene GraphicsScene;
@@ -33,6 +33,13 @@ public class FloatingChunk : RigidBody, ISpawned
 
     private bool isParticles;
 
+    private SimulationTier simulationTier = SimulationTier.Near;
+
+    /// <summary>
+    ///   Time the far updates haven't been done for yet
+    /// </summary>
+    private float farUpdateBacklog;
+
     public int DespawnRadiusSqr { get; set; }
 
     [JsonIgnore]
@@ -70,6 +77,31 @@ public class FloatingChunk : RigidBody, ISpawned
 
     public float Radius { get; set; }
 
+    [JsonIgnore]
+    public int PlanarBodyIndex { get; set; } = -1;
+
+    [JsonIgnore]
+    public float PlanarRadius => Radius;
+
+    [JsonIgnore]
+    public Vector3 QueuedPlanarImpulse { get; set; }
+
+    [JsonIgnore]
+    public SimulationTier SimulationTier
+    {
+        get => simulationTier;
+        set
+        {
+            if (simulationTier == value)
+                return;
+
+            simulationTier = value;
+
+            if (simulationTier == SimulationTier.Far)
+                farUpdateBacklog = SimulationTierSystem.GetStaggeredBacklog(this);
+        }
+    }
+
     public float ChunkScale { get; set; }
 
     /// <summary>
@@ -128,6 +160,23 @@ public class FloatingChunk : RigidBody, ISpawned
         }
     }
 
+    public bool PlanarCollidesWith(IPlanarPhysicsBody other)
+    {
+        return true;
+    }
+
+    public void OnPlanarContactBegin(IPlanarPhysicsBody other)
+    {
+        if (other is Microbe microbe)
+            touchingMicrobes.Add(microbe);
+    }
+
+    public void OnPlanarContactEnd(IPlanarPhysicsBody other)
+    {
+        if (other is Microbe microbe)
+            touchingMicrobes.Remove(microbe);
+    }
+
     /// <summary>
     ///   Reverses the action of Init back to a ChunkConfiguration
     /// </summary>
@@ -167,6 +216,18 @@ public class FloatingChunk : RigidBody, ISpawned
         return config;
     }
 
+    public override void _EnterTree()
+    {
+        PlanarPhysicsSystem.OnEntityEnteredTree(this);
+        MicrobeAISystem.OnChunkEnteredTree(this);
+    }
+
+    public override void _ExitTree()
+    {
+        PlanarPhysicsSystem.OnEntityExitedTree(this);
+        MicrobeAISystem.OnChunkExitedTree(this);
+    }
+
     public override void _Ready()
     {
         if (compoundClouds == null)
@@ -201,6 +262,12 @@ public class FloatingChunk : RigidBody, ISpawned
 
     public override void _Process(float delta)
     {
+        if (simulationTier == SimulationTier.Far && !SimulationTierSystem.TakeFarUpdateTime(ref farUpdateBacklog,
+            ref delta))
+        {
+            return;
+        }
+
         if (ContainedCompounds != null)
             VentCompounds(delta);
 
@@ -328,8 +395,8 @@ public class FloatingChunk : RigidBody, ISpawned
 
     private void VentCompound(Vector3 pos, Compound compound, float amount)
     {
-        compoundClouds.AddCloud(
-            compound, amount * Constants.CHUNK_VENT_COMPOUND_MULTIPLIER, pos);
+        compoundClouds.AddCloudStamp(
+            compound, amount * Constants.CHUNK_VENT_COMPOUND_MULTIPLIER, pos, CloudStamp.Point);
     }
 
     /// <summary>
@@ -57,9 +57,21 @@ public class FluidSystem
                 continue;
             }
 
+            // Far away entities don't drift so that their physics can sleep
+            if (body is ISimulationTiered tiered && tiered.SimulationTier == SimulationTier.Far)
+                continue;
+
             var pos = new Vector2(body.Translation.x, body.Translation.z);
             var vel = VelocityAt(pos) * Constants.MAX_FORCE_APPLIED_BY_CURRENTS;
-            body.ApplyCentralImpulse(new Vector3(vel.x, 0, vel.y));
+
+            if (body is IPlanarPhysicsBody planar && planar.PlanarBodyIndex >= 0)
+            {
+                planar.QueuedPlanarImpulse += new Vector3(vel.x, 0, vel.y);
+            }
+            else
+            {
+                body.ApplyCentralImpulse(new Vector3(vel.x, 0, vel.y));
+            }
         }
     }
 
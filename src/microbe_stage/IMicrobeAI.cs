@@ -13,4 +13,10 @@ public interface IMicrobeAI
     /// <param name="random">Randomness source</param>
     /// <param name="data">Common data for AI agents, should not be modified</param>
     void AIThink(float delta, Random random, MicrobeAICommonData data);
+
+    /// <summary>
+    ///   Performs the actions AIThink decided on that change the scene, like shooting toxins. Called by the
+    ///   MicrobeAISystem on the main thread for all the AI objects in order once the AI tasks have finished.
+    /// </summary>
+    void ApplyAIActions();
 }
@@ -0,0 +1,39 @@
+using Godot;
+
+/// <summary>
+///   RigidBody entities that can be simulated by the PlanarPhysicsSystem need to implement this
+/// </summary>
+public interface IPlanarPhysicsBody
+{
+    /// <summary>
+    ///   Index of this body in the planar physics system. -1 when this is not simulated by it.
+    ///   Should only be set by the PlanarPhysicsSystem.
+    /// </summary>
+    int PlanarBodyIndex { get; set; }
+
+    /// <summary>
+    ///   The radius of the circle collider used for this
+    /// </summary>
+    float PlanarRadius { get; }
+
+    /// <summary>
+    ///   Impulse that is applied on the next planar physics step, after which this is reset to zero
+    /// </summary>
+    Vector3 QueuedPlanarImpulse { get; set; }
+
+    /// <summary>
+    ///   Works like a collision exception. When either body in a pair returns false, the pair doesn't collide
+    ///   or report contacts.
+    /// </summary>
+    bool PlanarCollidesWith(IPlanarPhysicsBody other);
+
+    /// <summary>
+    ///   Called when this starts touching another body. Equivalent to the Godot body_shape_entered signal.
+    /// </summary>
+    void OnPlanarContactBegin(IPlanarPhysicsBody other);
+
+    /// <summary>
+    ///   Called when this stops touching another body, or the other body is removed
+    /// </summary>
+    void OnPlanarContactEnd(IPlanarPhysicsBody other);
+}
@@ -7,4 +7,9 @@ public interface IProcessable
 {
     List<TweakedProcess> ActiveProcesses { get; }
     CompoundBag ProcessCompoundStorage { get; }
+
+    /// <summary>
+    ///   Time that the processes haven't been ran for yet, used when the processes run less often than every frame
+    /// </summary>
+    float ProcessBacklog { get; set; }
 }
@@ -0,0 +1,10 @@
+/// <summary>
+///   Entities that are simulated with less detail when they are far from the player
+/// </summary>
+public interface ISimulationTiered
+{
+    /// <summary>
+    ///   Set by the SimulationTierSystem
+    /// </summary>
+    SimulationTier SimulationTier { get; set; }
+}
@@ -0,0 +1,143 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using Godot;
+using ICSharpCode.SharpZipLib.GZip;
+using File = Godot.File;
+
+/// <summary>
+///   Recorded player input, frame deltas and world seed of a microbe stage session. Used to replay a session
+///   frame exactly to reproduce performance problems.
+/// </summary>
+public class InputRecording
+{
+    private const string MAGIC = "ThriveInput";
+    private const int FORMAT_VERSION = 1;
+
+    public InputRecording(int seed)
+    {
+        Seed = seed;
+        GameVersion = Constants.Version;
+    }
+
+    private InputRecording(int seed, string gameVersion)
+    {
+        Seed = seed;
+        GameVersion = gameVersion;
+    }
+
+    /// <summary>
+    ///   The player actions active in a frame
+    /// </summary>
+    [Flags]
+    public enum Actions : ushort
+    {
+        None = 0,
+        Forward = 1 << 0,
+        Backwards = 1 << 1,
+        Left = 1 << 2,
+        Right = 1 << 3,
+        CheatGlucose = 1 << 4,
+        CheatAmmonia = 1 << 5,
+        CheatPhosphates = 1 << 6,
+
+        // These trigger once in the frame they are set
+        ToggleEngulf = 1 << 7,
+        FireToxin = 1 << 8,
+        CheatEditor = 1 << 9,
+    }
+
+    public int Seed { get; }
+
+    /// <summary>
+    ///   Version of the game that made this recording, replays may diverge on other versions
+    /// </summary>
+    public string GameVersion { get; }
+
+    public List<Frame> Frames { get; } = new List<Frame>();
+
+    /// <summary>
+    ///   Loads a recording from a file
+    /// </summary>
+    /// <exception cref="IOException">When the file can't be read</exception>
+    public static InputRecording Load(string path)
+    {
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Read) != Error.Ok)
+                throw new IOException($"can't open input recording: {path}");
+
+            using (var reader = new BinaryReader(new GZipInputStream(new GodotFileStream(file))))
+            {
+                if (reader.ReadString() != MAGIC)
+                    throw new IOException("file is not an input recording");
+
+                var version = reader.ReadInt32();
+
+                if (version != FORMAT_VERSION)
+                    throw new IOException($"unsupported input recording version: {version}");
+
+                var recording = new InputRecording(reader.ReadInt32(), reader.ReadString());
+
+                int count = reader.ReadInt32();
+                recording.Frames.Capacity = count;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    recording.Frames.Add(new Frame(reader.ReadSingle(), (Actions)reader.ReadUInt16(),
+                        new Vector2(reader.ReadSingle(), reader.ReadSingle())));
+                }
+
+                return recording;
+            }
+        }
+    }
+
+    /// <summary>
+    ///   Writes this recording to a file
+    /// </summary>
+    /// <exception cref="IOException">When the file can't be written</exception>
+    public void Save(string path)
+    {
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) != Error.Ok)
+                throw new IOException($"can't write input recording: {path}");
+
+            using (var writer = new BinaryWriter(new GZipOutputStream(new GodotFileStream(file))))
+            {
+                writer.Write(MAGIC);
+                writer.Write(FORMAT_VERSION);
+                writer.Write(Seed);
+                writer.Write(GameVersion);
+                writer.Write(Frames.Count);
+
+                foreach (var frame in Frames)
+                {
+                    writer.Write(frame.Delta);
+                    writer.Write((ushort)frame.Actions);
+                    writer.Write(frame.Cursor.x);
+                    writer.Write(frame.Cursor.y);
+                }
+            }
+        }
+    }
+
+    public struct Frame
+    {
+        public float Delta;
+        public Actions Actions;
+
+        /// <summary>
+        ///   Cursor position on the world plane (x and z)
+        /// </summary>
+        public Vector2 Cursor;
+
+        public Frame(float delta, Actions actions, Vector2 cursor)
+        {
+            Delta = delta;
+            Actions = actions;
+            Cursor = cursor;
+        }
+    }
+}
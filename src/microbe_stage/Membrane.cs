@@ -13,12 +13,44 @@ public class Membrane : MeshInstance
     /// </summary>
     public const float INVALID_FOUND_ORGANELLE = -999999.0f;
 
+    /// <summary>
+    ///   Size of a vertex in the vertex buffer. Godot 3 interleaves the attributes in the order of
+    ///   Mesh.ArrayType: position, tangent, colour, uv and second uv. Only the colour is compressed so that the
+    ///   buffer can be written here directly.
+    /// </summary>
+    private const int VERTEX_STRIDE = 12 + 16 + 4 + 8 + 8;
+
+    private const int TANGENT_OFFSET = 12;
+    private const int COLOUR_OFFSET = 28;
+    private const int UV_OFFSET = 32;
+    private const int UV2_OFFSET = 40;
+
+    /// <summary>
+    ///   The shader and render settings for the shared material of the membrane type, this isn't itself used
+    ///   for drawing
+    /// </summary>
     [Export]
     public ShaderMaterial MaterialToEdit;
 
     public MembraneType Type;
 
-    // private ArrayMesh generatedMesh;
+    private ArrayMesh generatedMesh;
+
+    /// <summary>
+    ///   Copy of the vertex buffer of generatedMesh. The per-instance values are written into this and it is
+    ///   uploaded with SurfaceUpdateRegion, so the surface doesn't need to be created again when they change.
+    /// </summary>
+    private byte[] vertexData;
+
+    /// <summary>
+    ///   False when vertexData doesn't have the per-instance values yet
+    /// </summary>
+    private bool instanceValuesWritten;
+
+    // The per-instance values in vertexData, used to skip writing the same values again
+    private Color writtenTint;
+    private Vector2 writtenValues;
+    private Vector2 writtenWigglyNess;
 
     private float healthFraction = 1.0f;
     private float wigglyNess = 1.0f;
@@ -28,13 +60,20 @@ public class Membrane : MeshInstance
     private Color tint = new Color(1, 1, 1, 1);
     private float dissolveEffectValue;
 
-    private Texture normalTexture;
-    private Texture damagedTexture;
-    private Texture noiseTexture;
+    private bool dirty = true;
 
-    private string currentlyLoadedNormalTexture;
+    private bool reducedDetail;
+
+    /// <summary>
+    ///   When true only the mesh needs to be built again from the existing outline
+    /// </summary>
+    private bool meshDirty;
+
+    /// <summary>
+    ///   When true the per-instance values have changed and need to be written to the mesh
+    /// </summary>
+    private bool instanceValuesDirty;
 
-    private bool dirty = true;
     private bool radiusIsDirty = true;
     private float cachedRadius;
 
@@ -56,6 +95,11 @@ public class Membrane : MeshInstance
     /// </summary>
     private List<Vector2> vertices2D;
 
+    /// <summary>
+    ///   The outline points the mesh was built from, this is vertices2D unless in reduced detail
+    /// </summary>
+    private List<Vector2> meshVertices2D;
+
     /// <summary>
     ///   When true the mesh needs to be regenerated and material properties applied
     /// </summary>
@@ -75,6 +119,37 @@ public class Membrane : MeshInstance
     /// </summary>
     public List<Vector2> OrganellePositions { get; set; }
 
+    /// <summary>
+    ///   Size of the generated mesh data: positions, uvs and the indices. 0 before the mesh is generated.
+    /// </summary>
+    public int MeshBytes
+    {
+        get
+        {
+            if (meshVertices2D == null)
+                return 0;
+
+            return (meshVertices2D.Count + 2) * VERTEX_STRIDE + meshVertices2D.Count * 3 * sizeof(int);
+        }
+    }
+
+    /// <summary>
+    ///   When true the mesh is built from only some of the outline points. The full outline is still used for
+    ///   the gameplay calculations.
+    /// </summary>
+    public bool ReducedDetail
+    {
+        get => reducedDetail;
+        set
+        {
+            if (reducedDetail == value)
+                return;
+
+            reducedDetail = value;
+            meshDirty = true;
+        }
+    }
+
     /// <summary>
     ///   How healthy the cell is, mixes in a damaged texture. Range 0.0f - 1.0f
     /// </summary>
@@ -88,8 +163,7 @@ public class Membrane : MeshInstance
                 return;
 
             healthFraction = value;
-            if (MaterialToEdit != null)
-                ApplyHealth();
+            instanceValuesDirty = true;
         }
     }
 
@@ -101,9 +175,11 @@ public class Membrane : MeshInstance
         get => wigglyNess;
         set
         {
+            if (wigglyNess == value)
+                return;
+
             wigglyNess = value;
-            if (MaterialToEdit != null)
-                ApplyWiggly();
+            instanceValuesDirty = true;
         }
     }
 
@@ -112,9 +188,11 @@ public class Membrane : MeshInstance
         get => movementWigglyNess;
         set
         {
+            if (movementWigglyNess == value)
+                return;
+
             movementWigglyNess = value;
-            if (MaterialToEdit != null)
-                ApplyMovementWiggly();
+            instanceValuesDirty = true;
         }
     }
 
@@ -135,10 +213,7 @@ public class Membrane : MeshInstance
                 return;
 
             tint = value;
-
-            // If we already have created a material we need to re-apply it
-            if (MaterialToEdit != null)
-                ApplyTint();
+            instanceValuesDirty = true;
         }
     }
 
@@ -159,14 +234,19 @@ public class Membrane : MeshInstance
         }
     }
 
+    /// <summary>
+    ///   How far the membrane has dissolved, fully at 1. Can be set higher, which draws the same as 1.
+    /// </summary>
     public float DissolveEffectValue
     {
         get => dissolveEffectValue;
         set
         {
+            if (dissolveEffectValue == value)
+                return;
+
             dissolveEffectValue = value;
-            if (MaterialToEdit != null)
-                ApplyDissolveEffect();
+            instanceValuesDirty = true;
         }
     }
 
@@ -183,10 +263,20 @@ public class Membrane : MeshInstance
 
     public override void _Process(float delta)
     {
-        if (!Dirty)
-            return;
-
-        Update();
+        if (Dirty)
+        {
+            Update();
+        }
+        else if (meshDirty)
+        {
+            BuildMesh();
+            WriteInstanceValues();
+        }
+        else if (instanceValuesDirty)
+        {
+            // All the changes during a frame are written with a single mesh update
+            WriteInstanceValues();
+        }
     }
 
     /// <summary>
@@ -330,67 +420,102 @@ public class Membrane : MeshInstance
     {
         Dirty = false;
         InitializeMesh();
-        ApplyAllMaterialParameters();
+        WriteInstanceValues();
     }
 
-    private void ApplyAllMaterialParameters()
-    {
-        ApplyWiggly();
-        ApplyMovementWiggly();
-        ApplyHealth();
-        ApplyTint();
-        ApplyTextures();
-        ApplyDissolveEffect();
-    }
-
-    private void ApplyWiggly()
-    {
-        float wigglyNessToApply =
-            WigglyNess / (EncompassingCircleRadius * sizeWigglyNessDampeningFactor);
-
-        MaterialToEdit.SetShaderParam("wigglyNess", Mathf.Min(WigglyNess, wigglyNessToApply));
-    }
-
-    private void ApplyMovementWiggly()
+    /// <summary>
+    ///   Writes the per-instance values into the vertex buffer of the mesh, if they have changed since the last
+    ///   write
+    /// </summary>
+    private unsafe void WriteInstanceValues()
     {
-        float wigglyNessToApply =
-            MovementWigglyNess / (EncompassingCircleRadius * sizeMovementWigglyNessDampeningFactor);
+        instanceValuesDirty = false;
 
-        MaterialToEdit.SetShaderParam("movementWigglyNess", Mathf.Min(MovementWigglyNess, wigglyNessToApply));
-    }
+        if (generatedMesh == null)
+            return;
 
-    private void ApplyHealth()
-    {
-        MaterialToEdit.SetShaderParam("healthFraction", HealthFraction);
-    }
+        // The wiggle is dampened for big cells
+        var wigglyNessToApply = new Vector2(
+            Mathf.Min(WigglyNess, WigglyNess / (EncompassingCircleRadius * sizeWigglyNessDampeningFactor)),
+            Mathf.Min(MovementWigglyNess,
+                MovementWigglyNess / (EncompassingCircleRadius * sizeMovementWigglyNessDampeningFactor)));
 
-    private void ApplyTint()
-    {
-        MaterialToEdit.SetShaderParam("tint", Tint);
-    }
+        // The dissolve value keeps increasing after the membrane is fully dissolved, the clamp makes those
+        // changes not cause writes
+        var values = new Vector2(HealthFraction, Mathf.Clamp(DissolveEffectValue, 0, 1));
 
-    private void ApplyTextures()
-    {
-        // We must update the texture on already-existing membranes,
-        // due to the membrane texture changing for the player microbe.
-        if (normalTexture != null && currentlyLoadedNormalTexture == Type.NormalTexture)
+        if (instanceValuesWritten && values == writtenValues && Tint == writtenTint &&
+            wigglyNessToApply == writtenWigglyNess)
+        {
             return;
+        }
 
-        normalTexture = Type.LoadedNormalTexture;
-        damagedTexture = Type.LoadedDamagedTexture;
+        instanceValuesWritten = true;
+        writtenValues = values;
+        writtenTint = Tint;
+        writtenWigglyNess = wigglyNessToApply;
 
-        noiseTexture = GD.Load<Texture>("res://assets/textures/dissolve_noise.tres");
+        // Same conversion as what Godot does for compressed colours
+        byte r = (byte)Mathf.Clamp((int)(Tint.r * 255), 0, 255);
+        byte g = (byte)Mathf.Clamp((int)(Tint.g * 255), 0, 255);
+        byte b = (byte)Mathf.Clamp((int)(Tint.b * 255), 0, 255);
+        byte a = (byte)Mathf.Clamp((int)(Tint.a * 255), 0, 255);
 
-        MaterialToEdit.SetShaderParam("albedoTexture", normalTexture);
-        MaterialToEdit.SetShaderParam("damagedTexture", damagedTexture);
-        MaterialToEdit.SetShaderParam("dissolveTexture", noiseTexture);
+        int vertexCount = vertexData.Length / VERTEX_STRIDE;
 
-        currentlyLoadedNormalTexture = Type.NormalTexture;
+        fixed (byte* data = vertexData)
+        {
+            for (int i = 0; i < vertexCount; ++i)
+            {
+                byte* vertex = data + i * VERTEX_STRIDE;
+
+                var tangent = (float*)(vertex + TANGENT_OFFSET);
+                tangent[0] = wigglyNessToApply.x;
+                tangent[1] = wigglyNessToApply.y;
+                tangent[2] = 0;
+                tangent[3] = 1;
+
+                vertex[COLOUR_OFFSET] = r;
+                vertex[COLOUR_OFFSET + 1] = g;
+                vertex[COLOUR_OFFSET + 2] = b;
+                vertex[COLOUR_OFFSET + 3] = a;
+
+                var uv2 = (float*)(vertex + UV2_OFFSET);
+                uv2[0] = values.x;
+                uv2[1] = values.y;
+            }
+        }
+
+        // The attributes are interleaved with the positions so the whole buffer is uploaded, but that replaces
+        // the existing buffer instead of creating a new surface
+        generatedMesh.SurfaceUpdateRegion(0, 0, vertexData);
     }
 
-    private void ApplyDissolveEffect()
+    /// <summary>
+    ///   Writes the positions and uvs into a new vertexData, the per-instance values are written by
+    ///   WriteInstanceValues
+    /// </summary>
+    private unsafe void CreateVertexData(Vector3[] vertices, Vector2[] uvs)
     {
-        MaterialToEdit.SetShaderParam("dissolveValue", DissolveEffectValue);
+        vertexData = new byte[vertices.Length * VERTEX_STRIDE];
+        instanceValuesWritten = false;
+
+        fixed (byte* data = vertexData)
+        {
+            for (int i = 0; i < vertices.Length; ++i)
+            {
+                byte* vertex = data + i * VERTEX_STRIDE;
+
+                var position = (float*)vertex;
+                position[0] = vertices[i].x;
+                position[1] = vertices[i].y;
+                position[2] = vertices[i].z;
+
+                var uv = (float*)(vertex + UV_OFFSET);
+                uv[0] = uvs[i].x;
+                uv[1] = uvs[i].y;
+            }
+        }
     }
 
     /// <summary>
@@ -458,14 +583,26 @@ public class Membrane : MeshInstance
     }
 
     /// <summary>
-    ///   Creates the actual mesh object. Call InitializeMesh instead of this directly
+    ///   Creates the actual mesh object from the current outline. Call InitializeMesh instead of this directly
+    ///   when the outline needs to be generated.
     /// </summary>
     private void BuildMesh()
     {
+        meshDirty = false;
+        meshVertices2D = vertices2D;
+
+        if (reducedDetail)
+        {
+            meshVertices2D = new List<Vector2>();
+
+            for (int i = 0; i < vertices2D.Count; i += Constants.MEMBRANE_REDUCED_DETAIL_VERTEX_STEP)
+                meshVertices2D.Add(vertices2D[i]);
+        }
+
         // This is actually a triangle list, but the index buffer is used to build
         // the indices (to emulate a triangle fan)
-        var bufferSize = vertices2D.Count + 2;
-        var indexSize = vertices2D.Count * 3;
+        var bufferSize = meshVertices2D.Count + 2;
+        var indexSize = meshVertices2D.Count * 3;
 
         var arrays = new Array();
         arrays.Resize((int)Mesh.ArrayType.Max);
@@ -506,15 +643,21 @@ public class Membrane : MeshInstance
         arrays[(int)Mesh.ArrayType.Index] = indices;
         arrays[(int)Mesh.ArrayType.TexUv] = uvs;
 
-        // Create the mesh
-        var generatedMesh = new ArrayMesh();
+        // These only give the format of the surface, the per-instance values are written by WriteInstanceValues
+        arrays[(int)Mesh.ArrayType.Tangent] = new float[bufferSize * 4];
+        arrays[(int)Mesh.ArrayType.Color] = new Color[bufferSize];
+        arrays[(int)Mesh.ArrayType.TexUv2] = new Vector2[bufferSize];
+
+        // Create the mesh, only the colour is compressed to match VERTEX_STRIDE
+        generatedMesh = new ArrayMesh();
+        generatedMesh.AddSurfaceFromArrays(Mesh.PrimitiveType.Triangles, arrays, null,
+            (uint)Mesh.ArrayFormat.CompressColor);
 
-        var surfaceIndex = generatedMesh.GetSurfaceCount();
-        generatedMesh.AddSurfaceFromArrays(Mesh.PrimitiveType.Triangles, arrays);
+        CreateVertexData(vertices, uvs);
 
         // Apply the mesh to us
         Mesh = generatedMesh;
-        SetSurfaceMaterial(surfaceIndex, MaterialToEdit);
+        SetSurfaceMaterial(0, MembraneMaterials.Get(Type, MaterialToEdit));
     }
 
     private int InitializeCorrectMembrane(int writeIndex, Vector3[] vertices,
@@ -539,15 +682,15 @@ public class Membrane : MeshInstance
         uvs[writeIndex] = center;
         ++writeIndex;
 
-        for (int i = 0, end = vertices2D.Count; i < end + 1; i++)
+        for (int i = 0, end = meshVertices2D.Count; i < end + 1; i++)
         {
             // Finds the UV coordinates be projecting onto a plane and
             // stretching to fit a circle.
 
             float currentRadians = multiplier * i / end;
 
-            vertices[writeIndex] = new Vector3(vertices2D[i % end].x, height / 2,
-                vertices2D[i % end].y);
+            vertices[writeIndex] = new Vector3(meshVertices2D[i % end].x, height / 2,
+                meshVertices2D[i % end].y);
 
             uvs[writeIndex] = center +
                 new Vector2(Mathf.Cos(currentRadians), Mathf.Sin(currentRadians)) / 2;
@@ -0,0 +1,60 @@
+using System.Collections.Generic;
+using Godot;
+
+/// <summary>
+///   The materials of the membranes. All membranes of the same type share one material so that the renderer
+///   doesn't need to switch materials between them.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The values that differ between cells (health, tint, dissolve and the wiggle amounts) are not material
+///     parameters, Membrane writes them into the vertex colours, second uvs and tangents of its mesh.
+///   </para>
+/// </remarks>
+public static class MembraneMaterials
+{
+    private static readonly Dictionary<MembraneType, ShaderMaterial> Materials =
+        new Dictionary<MembraneType, ShaderMaterial>();
+
+    private static Texture noiseTexture;
+
+    /// <summary>
+    ///   Number of shared membrane materials that have been created
+    /// </summary>
+    public static int Count
+    {
+        get
+        {
+            lock (Materials)
+                return Materials.Count;
+        }
+    }
+
+    /// <summary>
+    ///   Returns the shared material of a membrane type, creating it on first use
+    /// </summary>
+    /// <param name="type">The membrane type to get the material for</param>
+    /// <param name="template">
+    ///   Material to copy the shader and render settings from when the material doesn't exist yet
+    /// </param>
+    public static ShaderMaterial Get(MembraneType type, ShaderMaterial template)
+    {
+        lock (Materials)
+        {
+            if (Materials.TryGetValue(type, out var material))
+                return material;
+
+            if (noiseTexture == null)
+                noiseTexture = GD.Load<Texture>("res://assets/textures/dissolve_noise.tres");
+
+            material = (ShaderMaterial)template.Duplicate();
+
+            material.SetShaderParam("albedoTexture", type.LoadedNormalTexture);
+            material.SetShaderParam("damagedTexture", type.LoadedDamagedTexture);
+            material.SetShaderParam("dissolveTexture", noiseTexture);
+
+            Materials[type] = material;
+            return material;
+        }
+    }
+}
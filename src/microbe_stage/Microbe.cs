@@ -9,7 +9,7 @@ using Newtonsoft.Json;
 /// </summary>
 [JsonObject(IsReference = true)]
 [JSONAlwaysDynamicType]
-public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
+public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI, IPlanarPhysicsBody, ISimulationTiered
 {
     /// <summary>
     ///   The stored compounds in this microbe
@@ -126,9 +126,33 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
     [JsonProperty]
     private MicrobeAI ai;
 
+    /// <summary>
+    ///   Toxin the AI decided to shoot, emitted on the main thread by ApplyAIActions
+    /// </summary>
+    private Compound queuedToxin;
+
     private PackedScene cellBurstEffectScene;
     private bool deathParticlesSpawned;
 
+    private SimulationTier simulationTier = SimulationTier.Near;
+
+    /// <summary>
+    ///   Time the far updates haven't been done for yet
+    /// </summary>
+    private float farUpdateBacklog;
+
+    private MicrobeVisualDetail visualDetail = MicrobeVisualDetail.Full;
+
+    /// <summary>
+    ///   Drawn instead of the membrane and organelles in the impostor detail level, created when first needed
+    /// </summary>
+    private MeshInstance impostor;
+
+    /// <summary>
+    ///   The species colour the impostor mesh was made with
+    /// </summary>
+    private Color impostorColour;
+
     /// <summary>
     ///   3d audio listener attached to this microbe if it is the player owned one.
     /// </summary>
@@ -239,6 +263,53 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         }
     }
 
+    [JsonIgnore]
+    public int PlanarBodyIndex { get; set; } = -1;
+
+    [JsonIgnore]
+    public float PlanarRadius => Radius;
+
+    [JsonIgnore]
+    public Vector3 QueuedPlanarImpulse { get; set; }
+
+    /// <summary>
+    ///   Away from the player the membrane doesn't wiggle or flash. Far away the AI thinks less often and the
+    ///   physics body is allowed to sleep.
+    /// </summary>
+    [JsonIgnore]
+    public SimulationTier SimulationTier
+    {
+        get => simulationTier;
+        set
+        {
+            if (simulationTier == value)
+                return;
+
+            simulationTier = value;
+            ApplySimulationTier();
+        }
+    }
+
+    [JsonIgnore]
+    public float ProcessBacklog { get; set; }
+
+    /// <summary>
+    ///   How detailed this is drawn, set by MicrobeVisualDetailSystem based on the camera distance
+    /// </summary>
+    [JsonIgnore]
+    public MicrobeVisualDetail VisualDetail
+    {
+        get => visualDetail;
+        set
+        {
+            if (visualDetail == value)
+                return;
+
+            visualDetail = value;
+            ApplyVisualDetail();
+        }
+    }
+
     /// <summary>
     ///   All organelle nodes need to be added to this node to make scale work
     /// </summary>
@@ -328,6 +399,18 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         _Ready();
     }
 
+    public override void _EnterTree()
+    {
+        PlanarPhysicsSystem.OnEntityEnteredTree(this);
+        MicrobeAISystem.OnMicrobeEnteredTree(this);
+    }
+
+    public override void _ExitTree()
+    {
+        PlanarPhysicsSystem.OnEntityExitedTree(this);
+        MicrobeAISystem.OnMicrobeExitedTree(this);
+    }
+
     public override void _Ready()
     {
         if (cloudSystem == null)
@@ -387,6 +470,9 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         Membrane.Tint = Species.Colour;
         Membrane.Dirty = true;
 
+        if (impostor != null)
+            UpdateImpostor();
+
         SetupMicrobeHitpoints();
     }
 
@@ -427,7 +513,7 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
     }
 
     /// <summary>
-    ///   Tries to fire a toxin if possible
+    ///   Tries to fire a toxin if possible. Must be called on the main thread, the AI uses QueueToxinEmission.
     /// </summary>
     public void EmitToxin(Compound agentType = null)
     {
@@ -472,7 +558,7 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
 
         SpawnHelpers.SpawnAgent(props, 10.0f, Constants.EMITTED_AGENT_LIFETIME,
             position, direction, GetParent(),
-            SpawnHelpers.LoadAgentScene(), this);
+            SpawnHelpers.LoadAgentScene(), this, SimulationRandom.Create());
 
         PlaySoundEffect("res://assets/sounds/soundeffects/microbe-release-toxin.ogg");
     }
@@ -623,7 +709,7 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         LinearVelocity = new Vector3(0, 0, 0);
         allOrganellesDivided = false;
 
-        var random = new Random();
+        var random = SimulationRandom.Create();
 
         // Releasing all the agents.
         // To not completely deadlock in this there is a maximum limit
@@ -648,7 +734,7 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
 
                 SpawnHelpers.SpawnAgent(props, 10.0f, Constants.EMITTED_AGENT_LIFETIME,
                     Translation, direction, GetParent(),
-                    agentScene, this);
+                    agentScene, this, random);
 
                 amount -= Constants.MINIMUM_AGENT_EMISSION_AMOUNT;
                 ++createdAgents;
@@ -992,6 +1078,12 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
 
     public override void _Process(float delta)
     {
+        if (simulationTier == SimulationTier.Far && !SimulationTierSystem.TakeFarUpdateTime(ref farUpdateBacklog,
+            ref delta))
+        {
+            return;
+        }
+
         // Updates the listener if this is the player owned microbe.
         if (listener != null)
         {
@@ -1021,7 +1113,15 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         if (AgentEmissionCooldown < 0)
             AgentEmissionCooldown = 0;
 
-        HandleFlashing(delta);
+        if (simulationTier == SimulationTier.Near)
+        {
+            HandleFlashing(delta);
+        }
+        else
+        {
+            flashDuration = Math.Max(0, flashDuration - delta);
+        }
+
         HandleHitpointsRegeneration(delta);
         HandleReproduction(delta);
 
@@ -1055,13 +1155,15 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
             ApplyMovementImpulse(totalMovement, delta);
 
             // Play movement sound if one isn't already playing.
-            if (!movementAudio.Playing)
+            if (simulationTier == SimulationTier.Near && !movementAudio.Playing)
                 movementAudio.Play();
         }
 
         // Rotation is applied in the physics force callback as that's
         // the place where the body rotation can be directly set
-        // without problems
+        // without problems. Kinematic bodies don't get that callback so planar bodies are rotated here.
+        if (PlanarBodyIndex >= 0)
+            Transform = GetNewPhysicsRotation(Transform);
 
         HandleCompoundVenting(delta);
 
@@ -1109,6 +1211,27 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         }
     }
 
+    /// <summary>
+    ///   Makes the next ApplyAIActions call shoot a toxin. Used by the AI as it runs in parallel and can't add nodes
+    ///   to the scene or use the shared random.
+    /// </summary>
+    public void QueueToxinEmission(Compound agentType)
+    {
+        queuedToxin = agentType;
+    }
+
+    public void ApplyAIActions()
+    {
+        if (queuedToxin == null)
+            return;
+
+        var agentType = queuedToxin;
+        queuedToxin = null;
+
+        if (!Dead)
+            EmitToxin(agentType);
+    }
+
     public override void _IntegrateForces(PhysicsDirectBodyState state)
     {
         // TODO: should movement also be applied here?
@@ -1116,6 +1239,32 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         state.Transform = GetNewPhysicsRotation(state.Transform);
     }
 
+    public bool PlanarCollidesWith(IPlanarPhysicsBody other)
+    {
+        // Same as the collision exception added when starting to engulf
+        return !(other is Microbe microbe && attemptingToEngulf.Contains(microbe));
+    }
+
+    public void OnPlanarContactBegin(IPlanarPhysicsBody other)
+    {
+        // Planar bodies don't have separate pilus shapes, so only the engulfing part of the contact logic applies
+        if (other is Microbe microbe && !microbe.Dead)
+        {
+            if (touchedMicrobes.Add(microbe))
+            {
+                CheckStartEngulfingOnCandidates();
+            }
+        }
+    }
+
+    public void OnPlanarContactEnd(IPlanarPhysicsBody other)
+    {
+        if (other is Microbe microbe)
+        {
+            touchedMicrobes.Remove(microbe);
+        }
+    }
+
     public void ApplyPropertiesFromSave(Microbe microbe)
     {
         SaveApplyHelper.CopyJSONSavedPropertiesAndFields(this, microbe, new List<string>
@@ -1206,6 +1355,76 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         }
     }
 
+    /// <summary>
+    ///   Applies the parts of the simulation tier that don't happen in the updates: staggers the far updates,
+    ///   lets the physics sleep when far away and turns off the membrane wiggle and flash colour when not near
+    /// </summary>
+    private void ApplySimulationTier()
+    {
+        if (simulationTier == SimulationTier.Far)
+            farUpdateBacklog = SimulationTierSystem.GetStaggeredBacklog(this);
+
+        // The physics server wakes the body up again if something touches it
+        if (simulationTier == SimulationTier.Far && PlanarBodyIndex < 0)
+            Sleeping = true;
+
+        if (Membrane == null)
+            return;
+
+        if (simulationTier == SimulationTier.Near)
+        {
+            Membrane.WigglyNess = 1.0f;
+        }
+        else
+        {
+            Membrane.WigglyNess = 0.0f;
+
+            // Don't leave a flash colour on, as flashing is only done near the player
+            Membrane.Tint = Species.Colour;
+        }
+    }
+
+    private void ApplyVisualDetail()
+    {
+        OrganelleParent.Visible = visualDetail == MicrobeVisualDetail.Full;
+        Membrane.Visible = visualDetail != MicrobeVisualDetail.Impostor;
+        Membrane.ReducedDetail = visualDetail == MicrobeVisualDetail.Reduced;
+
+        if (visualDetail == MicrobeVisualDetail.Impostor)
+        {
+            if (impostor == null)
+            {
+                impostor = new MeshInstance
+                {
+                    RotationDegrees = new Vector3(-90, 0, 0),
+                };
+
+                AddChild(impostor);
+            }
+
+            UpdateImpostor();
+            impostor.Visible = true;
+        }
+        else if (impostor != null)
+        {
+            impostor.Visible = false;
+        }
+    }
+
+    /// <summary>
+    ///   Sets the impostor colour and size to match the species and the membrane
+    /// </summary>
+    private void UpdateImpostor()
+    {
+        if (impostor.Mesh == null || impostorColour != Species.Colour)
+        {
+            impostor.Mesh = MicrobeImpostors.CreateMesh(Species.Colour);
+            impostorColour = Species.Colour;
+        }
+
+        impostor.Scale = Membrane.Scale * (Membrane.EncompassingCircleRadius * 2);
+    }
+
     /// <summary>
     ///   Flashes the membrane colour when Flash has been called
     /// </summary>
@@ -1692,6 +1911,12 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
             return;
 
         // Scale movement by delta time (not by framerate). We aren't Fallout 4
+        if (PlanarBodyIndex >= 0)
+        {
+            QueuedPlanarImpulse += movement * delta;
+            return;
+        }
+
         ApplyCentralImpulse(movement * delta);
     }
 
@@ -1786,6 +2011,10 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
 
         Membrane.OrganellePositions = organellePositions;
         Membrane.Dirty = true;
+
+        if (visualDetail == MicrobeVisualDetail.Impostor)
+            UpdateImpostor();
+
         membraneOrganellePositionsAreDirty = false;
     }
 
@@ -1806,7 +2035,7 @@ public class Microbe : RigidBody, ISpawned, IProcessable, IMicrobeAI
         if (amountToEject <= 0)
             return;
 
-        cloudSystem.AddCloud(compound, amountToEject, CalculateNearbyWorldPosition());
+        cloudSystem.AddCloudStamp(compound, amountToEject, CalculateNearbyWorldPosition(), CloudStamp.Point);
     }
 
     /// <summary>
@@ -150,14 +150,14 @@ public class MicrobeAI
                 prey = null;
                 if (predator == null)
                 {
-                    GetNearestPredatorItem(data.AllMicrobes);
+                    GetNearestPredatorItem(data);
                 }
 
                 // Peg your prey
                 if (!preyPegged)
                 {
                     prey = null;
-                    prey = GetNearestPreyItem(data.AllMicrobes);
+                    prey = GetNearestPreyItem(data);
                     if (prey != null)
                     {
                         preyPegged = true;
@@ -183,7 +183,7 @@ public class MicrobeAI
                 }
                 else
                 {
-                    DoRunAndTumble(random);
+                    DoRunAndTumble(random, data.CompoundGradients);
                 }
 
                 break;
@@ -193,7 +193,7 @@ public class MicrobeAI
             {
                 if (predator == null)
                 {
-                    GetNearestPredatorItem(data.AllMicrobes);
+                    GetNearestPredatorItem(data);
                 }
 
                 // In this state you run from predatory microbes
@@ -223,7 +223,7 @@ public class MicrobeAI
                 if (!preyPegged)
                 {
                     prey = null;
-                    prey = GetNearestPreyItem(data.AllMicrobes);
+                    prey = GetNearestPreyItem(data);
                     if (prey != null)
                     {
                         preyPegged = true;
@@ -232,7 +232,7 @@ public class MicrobeAI
 
                 if (preyPegged && prey != null)
                 {
-                    DealWithPrey(data.AllMicrobes, random);
+                    DealWithPrey(data, random);
                 }
                 else
                 {
@@ -279,7 +279,7 @@ public class MicrobeAI
         }
 
         // Run reflexes
-        DoReflexes();
+        DoReflexes(data);
 
         // Clear the absorbed compounds for run and rumble
         microbe.TotalAbsorbedCompounds.Clear();
@@ -313,7 +313,7 @@ public class MicrobeAI
         return ourStat >= random.Next(0.0f, dc);
     }
 
-    private void DoReflexes()
+    private void DoReflexes(MicrobeAICommonData data)
     {
         // For times when its best to tell the microbe directly what to do (Life threatening, attaching to things etc);
         /* Check if we are willing to run, and there is a predator nearby, if so, flee for your life
@@ -327,8 +327,16 @@ public class MicrobeAI
             {
                 if (!predator.Dead)
                 {
-                    if ((microbe.Translation - predator.Translation).LengthSquared() <=
-                        (2000 + ((predator.HexCount * 8.0f) * 2)))
+                    float fleeDistanceSquared = 2000 + ((predator.HexCount * 8.0f) * 2);
+
+                    // Toxins can hit from further away than engulfing
+                    if (data.Relationships.HasToxins(predator.Species))
+                    {
+                        fleeDistanceSquared *= Constants.AI_TOXIC_PREDATOR_FLEE_MULTIPLIER *
+                            Constants.AI_TOXIC_PREDATOR_FLEE_MULTIPLIER;
+                    }
+
+                    if ((microbe.Translation - predator.Translation).LengthSquared() <= fleeDistanceSquared)
                     {
                         if (lifeState != LifeState.FLEEING_STATE)
                         {
@@ -398,8 +406,8 @@ public class MicrobeAI
     ///   Gets the nearest prey item. And builds the prey list
     /// </summary>
     /// <returns>The nearest prey item.</returns>
-    /// <param name="allMicrobes">All microbes.</param>
-    private Microbe GetNearestPreyItem(List<Microbe> allMicrobes)
+    /// <param name="data">The microbes and their species relationships.</param>
+    private Microbe GetNearestPreyItem(MicrobeAICommonData data)
     {
         Microbe chosenPrey = null;
 
@@ -410,17 +418,14 @@ public class MicrobeAI
         Vector3 testPosition = new Vector3(0, 0, 0);
         bool setPosition = true;
 
-        foreach (var otherMicrobe in allMicrobes)
+        foreach (var otherMicrobe in data.AllMicrobes)
         {
             if (otherMicrobe == microbe)
                 continue;
 
             if (otherMicrobe.Species != microbe.Species && !otherMicrobe.Dead)
             {
-                if ((SpeciesAggression == Constants.MAX_SPECIES_AGRESSION) ||
-                    ((((microbe.AgentVacuoleCount + microbe.EngulfSize) * 1.0f) *
-                            (SpeciesAggression / Constants.AGRESSION_DIVISOR)) >
-                        (otherMicrobe.EngulfSize * 1.0f)))
+                if (data.Relationships.Get(microbe.Species, otherMicrobe.Species).IsPrey)
                 {
                     preyMicrobes.Add(otherMicrobe);
 
@@ -451,44 +456,36 @@ public class MicrobeAI
     /// <summary>
     ///   Building the predator list and setting the scariest one to be predator
     /// </summary>
-    /// <param name="allMicrobes">All microbes.</param>
-    private void GetNearestPredatorItem(List<Microbe> allMicrobes)
+    /// <param name="data">The microbes and their species relationships.</param>
+    private void GetNearestPredatorItem(MicrobeAICommonData data)
     {
-        // Retrive the nearest predator
+        // Retrive the scariest predator
         // For our desires lets just say all microbes bigger are potential predators
-        // and later extend this to include those with toxins and pilus
-        Vector3 testPosition = new Vector3(0, 0, 0);
-        bool setPosition = true;
+        // and later extend this to include those with pilus
+        float highestScariness = 0;
 
-        foreach (var otherMicrobe in allMicrobes)
+        foreach (var otherMicrobe in data.AllMicrobes)
         {
             if (otherMicrobe == microbe)
                 continue;
 
-            // At max fear add them all
+            // At max fear the relationship makes them all predators
             if (otherMicrobe.Species != microbe.Species && !otherMicrobe.Dead)
             {
-                if ((SpeciesFear == Constants.MAX_SPECIES_FEAR) ||
-                    ((((microbe.AgentVacuoleCount + otherMicrobe.EngulfSize) * 1.0f) *
-                            (SpeciesFear / Constants.FEAR_DIVISOR)) >
-                        (microbe.EngulfSize * 1.0f)))
+                var relationship = data.Relationships.Get(microbe.Species, otherMicrobe.Species);
+
+                if (relationship.IsPredator)
                 {
                     // You are bigger then me and i am afraid of that
                     predatoryMicrobes.Add(otherMicrobe);
-                    var thisPosition = otherMicrobe.Translation;
 
-                    // At max aggression add them all
-                    if (setPosition)
-                    {
-                        testPosition = thisPosition;
-                        setPosition = false;
-                        predator = otherMicrobe;
-                    }
+                    // Close predators are scarier than far away ones with the same threat
+                    float scariness = relationship.ThreatLevel /
+                        Math.Max(1, (otherMicrobe.Translation - microbe.Translation).LengthSquared());
 
-                    if ((testPosition - microbe.Translation).LengthSquared() >
-                        (thisPosition - microbe.Translation).LengthSquared())
+                    if (predator == null || scariness > highestScariness)
                     {
-                        testPosition = thisPosition;
+                        highestScariness = scariness;
                         predator = otherMicrobe;
                     }
                 }
@@ -499,7 +496,7 @@ public class MicrobeAI
     /// <summary>
     /// For chasing down and killing prey in various ways
     /// </summary>
-    private void DealWithPrey(List<Microbe> allMicrobes, Random random)
+    private void DealWithPrey(MicrobeAICommonData data, Random random)
     {
         // Tick the engulf tick
         ticksSinceLastToggle += 1;
@@ -550,7 +547,7 @@ public class MicrobeAI
         if (prey.Dead)
         {
             hasTargetPosition = false;
-            prey = GetNearestPreyItem(allMicrobes);
+            prey = GetNearestPreyItem(data);
             if (prey != null)
             {
                 preyPegged = true;
@@ -601,7 +598,7 @@ public class MicrobeAI
             {
                 if (microbe.Compounds.GetCompoundAmount(oxytoxy) >= Constants.MINIMUM_AGENT_EMISSION_AMOUNT)
                 {
-                    microbe.EmitToxin(oxytoxy);
+                    microbe.QueueToxinEmission(oxytoxy);
                 }
             }
         }
@@ -744,7 +741,7 @@ public class MicrobeAI
             {
                 if (microbe.Compounds.GetCompoundAmount(oxytoxy) >= Constants.MINIMUM_AGENT_EMISSION_AMOUNT)
                 {
-                    microbe.EmitToxin(oxytoxy);
+                    microbe.QueueToxinEmission(oxytoxy);
                 }
             }
         }
@@ -839,7 +836,7 @@ public class MicrobeAI
     }
 
     // For doing run and tumble
-    private void DoRunAndTumble(Random random)
+    private void DoRunAndTumble(Random random, CompoundGradientField compoundGradients)
     {
         // Run and tumble
         // A biased random walk, they turn more if they are picking up less compounds.
@@ -877,6 +874,19 @@ public class MicrobeAI
             targetPosition = new Vector3(Mathf.Cos(randAngle) * randDist, 0, Mathf.Sin(randAngle) * randDist);
         }
 
+        // When not finding much, head towards where the clouds have more of the compounds this cell uses
+        if (compoundDifference < Constants.AI_COMPOUND_BIAS && compoundGradients != null)
+        {
+            var gradient = compoundGradients.GetGradient(microbe.Translation, microbe.Compounds);
+
+            if (gradient.Length() > Constants.AI_COMPOUND_GRADIENT_MIN_STRENGTH)
+            {
+                randAngle = Mathf.Atan2(gradient.z, gradient.x);
+                randDist = random.Next(200.0f, movementRadius);
+                targetPosition = microbe.Translation + gradient.Normalized() * randDist;
+            }
+        }
+
         // Turn more if not in concentration gradient basically (step is .4 if really no food, .3 if less food, .1 if
         // in food)
         previousAngle = randAngle;
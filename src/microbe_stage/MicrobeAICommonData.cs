@@ -5,12 +5,36 @@
 /// </summary>
 public class MicrobeAICommonData
 {
-    public MicrobeAICommonData(List<Microbe> allMicrobes, List<FloatingChunk> allChunks)
+    public MicrobeAICommonData(List<Microbe> allMicrobes, List<FloatingChunk> allChunks,
+        SpeciesRelationships relationships, CompoundGradientField compoundGradients)
     {
         AllMicrobes = allMicrobes;
         AllChunks = allChunks;
+        Relationships = relationships;
+        CompoundGradients = compoundGradients;
     }
 
-    public List<Microbe> AllMicrobes { get; }
-    public List<FloatingChunk> AllChunks { get; }
+    public List<Microbe> AllMicrobes { get; private set; }
+    public List<FloatingChunk> AllChunks { get; private set; }
+
+    /// <summary>
+    ///   Prey and predator relationships between the species of AllMicrobes
+    /// </summary>
+    public SpeciesRelationships Relationships { get; }
+
+    /// <summary>
+    ///   Where the compounds in the clouds are, for the gathering AI
+    /// </summary>
+    public CompoundGradientField CompoundGradients { get; private set; }
+
+    /// <summary>
+    ///   Points this to the data of a new frame, so that the same object can be used each frame
+    /// </summary>
+    public void Update(List<Microbe> allMicrobes, List<FloatingChunk> allChunks,
+        CompoundGradientField compoundGradients)
+    {
+        AllMicrobes = allMicrobes;
+        AllChunks = allChunks;
+        CompoundGradients = compoundGradients;
+    }
 }
@@ -1,55 +1,214 @@
 ﻿using System;
 using System.Collections.Generic;
-using System.Linq;
+using System.Diagnostics;
 using System.Threading.Tasks;
 using Godot;
 
+/// <summary>
+///   Runs the AI of the microbes in parallel
+/// </summary>
+/// <remarks>
+///   <para>
+///     The node groups aren't queried each frame as that allocates new arrays. Instead microbes and chunks add
+///     themselves to lists here when they enter the scene tree and remove themselves when they exit it, and the
+///     group membership is checked from those. The task delegate and the boxed task start indices are kept
+///     between frames, only the Task objects themselves are created each frame as they can't be run again.
+///   </para>
+/// </remarks>
 public class MicrobeAISystem
 {
+    /// <summary>
+    ///   The microbes and chunks in the scene tree. Lists to keep the order the same between runs. Only used on
+    ///   the main thread.
+    /// </summary>
+    private static readonly List<Microbe> MicrobesInTree = new List<Microbe>();
+
+    private static readonly List<FloatingChunk> ChunksInTree = new List<FloatingChunk>();
+
     private readonly List<Task> tasks = new List<Task>();
+    private readonly Stopwatch stopwatch = new Stopwatch();
+    private readonly SpeciesRelationships relationships = new SpeciesRelationships();
+
+    /// <summary>
+    ///   Boxed start index of each task, kept so that the indices aren't boxed again each frame
+    /// </summary>
+    private readonly List<object> taskStarts = new List<object>();
+
+    /// <summary>
+    ///   One random per task when not running deterministically, so that the threads don't share them
+    /// </summary>
+    private readonly List<Random> taskRandoms = new List<Random>();
+
+    /// <summary>
+    ///   Seeds the task randoms. SimulationRandom isn't used for these as the task count depends on the timing.
+    /// </summary>
+    private readonly Random taskSeeds = new Random();
+
+    private readonly Action<object> runTask;
 
     private readonly Node worldRoot;
+    private readonly CompoundCloudSystem clouds;
+    private readonly CollectionArena frameArena;
+
+    /// <summary>
+    ///   The data given to the AI, reused between the frames
+    /// </summary>
+    private MicrobeAICommonData data;
+
+    /// <summary>
+    ///   Counts the runs, used to seed the per object randoms when the simulation is deterministic
+    /// </summary>
+    private int frame;
+
+    // The parameters of the current run, read by the tasks
+    private List<Microbe> runNodes;
+    private float runDelta;
+    private int runObjectsPerTask;
+    private bool runDeterministic;
+    private int runFrame;
 
-    public MicrobeAISystem(Node worldRoot)
+    public MicrobeAISystem(Node worldRoot, CompoundCloudSystem clouds, CollectionArena frameArena)
     {
         this.worldRoot = worldRoot;
+        this.clouds = clouds;
+        this.frameArena = frameArena;
+
+        runTask = RunTask;
+    }
+
+    /// <summary>
+    ///   Called by the microbes in _EnterTree
+    /// </summary>
+    public static void OnMicrobeEnteredTree(Microbe microbe)
+    {
+        MicrobesInTree.Add(microbe);
+    }
+
+    /// <summary>
+    ///   Called by the microbes in _ExitTree
+    /// </summary>
+    public static void OnMicrobeExitedTree(Microbe microbe)
+    {
+        MicrobesInTree.Remove(microbe);
+    }
+
+    /// <summary>
+    ///   Called by the chunks in _EnterTree
+    /// </summary>
+    public static void OnChunkEnteredTree(FloatingChunk chunk)
+    {
+        ChunksInTree.Add(chunk);
+    }
+
+    /// <summary>
+    ///   Called by the chunks in _ExitTree
+    /// </summary>
+    public static void OnChunkExitedTree(FloatingChunk chunk)
+    {
+        ChunksInTree.Remove(chunk);
     }
 
     public void Process(float delta)
     {
-        var nodes = worldRoot.GetTree().GetNodesInGroup(Constants.AI_GROUP);
+        stopwatch.Restart();
+        var allocationStart = AllocationTracker.Instance.BeginMeasure();
+
+        // These are borrowed for the frame, the AI tasks only read them
+        var nodes = frameArena.BorrowList<Microbe>();
+        var microbes = frameArena.BorrowList<Microbe>();
+        var chunks = frameArena.BorrowList<FloatingChunk>();
 
-        // TODO: it would be nice to only rebuild these lists if some AI think interval has elapsed and these are needed
-        var allMicrobes = worldRoot.GetTree().GetNodesInGroup(Constants.AI_TAG_MICROBE);
-        var allChunks = worldRoot.GetTree().GetNodesInGroup(Constants.AI_TAG_CHUNK);
+        for (int i = 0; i < MicrobesInTree.Count; ++i)
+        {
+            var microbe = MicrobesInTree[i];
+
+            if (!worldRoot.IsAParentOf(microbe))
+                continue;
+
+            if (microbe.IsInGroup(Constants.AI_TAG_MICROBE))
+                microbes.Add(microbe);
+
+            if (microbe.IsInGroup(Constants.AI_GROUP))
+                nodes.Add(microbe);
+        }
 
-        var data = new MicrobeAICommonData(allMicrobes.Cast<Microbe>().ToList(),
-            allChunks.Cast<FloatingChunk>().ToList());
+        for (int i = 0; i < ChunksInTree.Count; ++i)
+        {
+            var chunk = ChunksInTree[i];
+
+            if (worldRoot.IsAParentOf(chunk) && chunk.IsInGroup(Constants.AI_TAG_CHUNK))
+                chunks.Add(chunk);
+        }
+
+        // The AI tasks only read this, so it is built here before they start
+        relationships.Build(microbes);
+
+        if (data == null)
+        {
+            data = new MicrobeAICommonData(microbes, chunks, relationships, clouds.GradientField);
+        }
+        else
+        {
+            data.Update(microbes, chunks, clouds.GradientField);
+        }
 
         // The objects are processed here in order to take advantage of threading
         var executor = TaskExecutor.Instance;
 
-        for (int i = 0; i < nodes.Count; i += Constants.MICROBE_AI_OBJECTS_PER_TASK)
-        {
-            int start = i;
+        var tuner = QualityGovernor.Instance.AITasks;
+        runObjectsPerTask = tuner.BeginRun(nodes.Count);
+        runNodes = nodes;
+        runDelta = delta;
+
+        // The task sizes change with the measured timing, so for repeatable runs each object needs its own random
+        runDeterministic = SimulationRandom.Deterministic;
+        runFrame = frame++;
 
-            var task = new Task(() =>
+        for (int i = 0, taskIndex = 0; i < nodes.Count; i += runObjectsPerTask, ++taskIndex)
+        {
+            if (taskIndex >= taskStarts.Count)
             {
-                var random = new Random();
-                for (int a = start;
-                    a < start + Constants.MICROBE_AI_OBJECTS_PER_TASK && a < nodes.Count;
-                    ++a)
-                {
-                    RunAIFor(nodes[a] as IMicrobeAI, delta, random, data);
-                }
-            });
-
-            tasks.Add(task);
+                taskStarts.Add(taskIndex);
+                taskRandoms.Add(new Random(taskSeeds.Next()));
+            }
+
+            tasks.Add(new Task(runTask, taskStarts[taskIndex]));
         }
 
         // Start and wait for tasks to finish
         executor.RunTasks(tasks);
         tasks.Clear();
+        tuner.EndRun();
+        runNodes = null;
+
+        // Spawning things needs to happen on the main thread, and going through the objects in order keeps the
+        // spawned entities and the used random numbers the same between runs
+        for (int i = 0; i < nodes.Count; ++i)
+            nodes[i].ApplyAIActions();
+
+        QualityGovernor.Instance.ReportSystemTime(QualityGovernor.GovernedSystem.AI,
+            (float)stopwatch.Elapsed.TotalMilliseconds);
+        AllocationTracker.Instance.EndMeasure(QualityGovernor.GovernedSystem.AI, allocationStart);
+    }
+
+    /// <summary>
+    ///   Runs the AI for one task worth of objects
+    /// </summary>
+    /// <param name="state">The boxed index of the task</param>
+    private void RunTask(object state)
+    {
+        var tuner = QualityGovernor.Instance.AITasks;
+        var taskStart = tuner.TaskStarted();
+
+        int taskIndex = (int)state;
+        int start = taskIndex * runObjectsPerTask;
+        var random = runDeterministic ? null : taskRandoms[taskIndex];
+        int a;
+
+        for (a = start; a < start + runObjectsPerTask && a < runNodes.Count; ++a)
+            RunAIFor(runNodes[a], runDelta, random ?? SimulationRandom.CreateFor(runFrame, a), data);
+
+        tuner.TaskFinished(taskStart, a - start);
     }
 
     /// <summary>
@@ -74,7 +233,15 @@ public class MicrobeAISystem
         if (ai.TimeUntilNextAIUpdate > 0)
             return;
 
-        ai.TimeUntilNextAIUpdate = Constants.MICROBE_AI_THINK_INTERVAL;
+        // Far away cells don't need to react quickly
+        if (ai is ISimulationTiered tiered && tiered.SimulationTier == SimulationTier.Far)
+        {
+            ai.TimeUntilNextAIUpdate = Constants.SIMULATION_TIER_FAR_AI_THINK_INTERVAL;
+        }
+        else
+        {
+            ai.TimeUntilNextAIUpdate = Constants.MICROBE_AI_THINK_INTERVAL;
+        }
 
         ai.AIThink(delta, random, data);
     }
@@ -0,0 +1,261 @@
+using System;
+using System.Collections.Generic;
+
+/// <summary>
+///   Canonical form of the parts of a microbe species that most of the costly calculations depend on: the
+///   organelle layout and the membrane. Layouts that only differ by being moved or rotated on the hex grid give
+///   equal genomes, so caches can key on this to share work between identical designs.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The layout is rotated to each of the 6 hex rotations and moved so that its smallest organelle position is
+///     at the origin, the rotation that gives the smallest sorted organelle list is the canonical one. The hash
+///     is 64-bit FNV-1a over the canonical data so it stays the same between runs and platforms.
+///   </para>
+///   <para>
+///     Genomes are immutable, use Intern to get the shared instance of a genome.
+///   </para>
+/// </remarks>
+public class MicrobeGenome : IEquatable<MicrobeGenome>
+{
+    private const ulong FNV_OFFSET_BASIS = 14695981039346656037;
+    private const ulong FNV_PRIME = 1099511628211;
+
+    private static readonly Dictionary<MicrobeGenome, MicrobeGenome> InternTable =
+        new Dictionary<MicrobeGenome, MicrobeGenome>();
+
+    private readonly OrganelleEntry[] organelles;
+
+    private MicrobeGenome(string membraneType, bool isBacteria, float membraneRigidity,
+        OrganelleEntry[] organelles)
+    {
+        MembraneType = membraneType;
+        IsBacteria = isBacteria;
+        MembraneRigidity = membraneRigidity;
+        this.organelles = organelles;
+
+        Hash = CalculateHash();
+    }
+
+    /// <summary>
+    ///   Number of genomes in the intern table
+    /// </summary>
+    public static int InternedCount
+    {
+        get
+        {
+            lock (InternTable)
+                return InternTable.Count;
+        }
+    }
+
+    public ulong Hash { get; }
+
+    /// <summary>
+    ///   Internal name of the membrane type
+    /// </summary>
+    public string MembraneType { get; }
+
+    public bool IsBacteria { get; }
+
+    public float MembraneRigidity { get; }
+
+    public int OrganelleCount => organelles.Length;
+
+    public static bool operator ==(MicrobeGenome left, MicrobeGenome right)
+    {
+        return Equals(left, right);
+    }
+
+    public static bool operator !=(MicrobeGenome left, MicrobeGenome right)
+    {
+        return !Equals(left, right);
+    }
+
+    public static MicrobeGenome FromSpecies(MicrobeSpecies species)
+    {
+        return FromLayout(species.Organelles, species.MembraneType, species.IsBacteria, species.MembraneRigidity);
+    }
+
+    public static MicrobeGenome FromLayout(IEnumerable<OrganelleTemplate> layout, MembraneType membraneType,
+        bool isBacteria, float membraneRigidity)
+    {
+        var source = new List<OrganelleEntry>();
+
+        foreach (var organelle in layout)
+        {
+            source.Add(new OrganelleEntry(organelle.Definition.InternalName, organelle.Position,
+                organelle.Orientation));
+        }
+
+        OrganelleEntry[] best = null;
+
+        for (int rotation = 0; rotation < 6; ++rotation)
+        {
+            var candidate = CreateNormalized(source, rotation);
+
+            if (best == null || Compare(candidate, best) < 0)
+                best = candidate;
+        }
+
+        return new MicrobeGenome(membraneType?.InternalName ?? string.Empty, isBacteria, membraneRigidity, best);
+    }
+
+    /// <summary>
+    ///   Returns the shared instance of an equal genome, adding this one to the table if there isn't one
+    /// </summary>
+    public static MicrobeGenome Intern(MicrobeGenome genome)
+    {
+        lock (InternTable)
+        {
+            if (InternTable.TryGetValue(genome, out var existing))
+                return existing;
+
+            // Genomes that were handed out stay valid, they just won't be shared with the ones interned after this
+            if (InternTable.Count >= Constants.GENOME_INTERN_TABLE_MAX_SIZE)
+                InternTable.Clear();
+
+            InternTable[genome] = genome;
+            return genome;
+        }
+    }
+
+    public bool Equals(MicrobeGenome other)
+    {
+        if (ReferenceEquals(this, other))
+            return true;
+
+        if (other is null || Hash != other.Hash || IsBacteria != other.IsBacteria ||
+            MembraneRigidity != other.MembraneRigidity || MembraneType != other.MembraneType)
+        {
+            return false;
+        }
+
+        return Compare(organelles, other.organelles) == 0;
+    }
+
+    public override bool Equals(object obj)
+    {
+        return Equals(obj as MicrobeGenome);
+    }
+
+    public override int GetHashCode()
+    {
+        return (int)Hash ^ (int)(Hash >> 32);
+    }
+
+    public override string ToString()
+    {
+        return $"{Hash:x16} ({OrganelleCount} organelles, {MembraneType})";
+    }
+
+    private static OrganelleEntry[] CreateNormalized(List<OrganelleEntry> source, int rotation)
+    {
+        var result = new OrganelleEntry[source.Count];
+
+        for (int i = 0; i < source.Count; ++i)
+        {
+            var entry = source[i];
+            result[i] = new OrganelleEntry(entry.Name, Hex.RotateAxialNTimes(entry.Position, rotation),
+                (entry.Orientation + rotation) % 6);
+        }
+
+        Array.Sort(result);
+
+        // After sorting the first entry has the smallest position
+        if (result.Length > 0)
+        {
+            var offset = result[0].Position;
+
+            for (int i = 0; i < result.Length; ++i)
+                result[i].Position -= offset;
+        }
+
+        return result;
+    }
+
+    private static int Compare(OrganelleEntry[] first, OrganelleEntry[] second)
+    {
+        if (first.Length != second.Length)
+            return first.Length.CompareTo(second.Length);
+
+        for (int i = 0; i < first.Length; ++i)
+        {
+            int result = first[i].CompareTo(second[i]);
+
+            if (result != 0)
+                return result;
+        }
+
+        return 0;
+    }
+
+    private static ulong HashValue(ulong hash, int value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            hash ^= (byte)(value >> (i * 8));
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    private static ulong HashValue(ulong hash, string value)
+    {
+        foreach (var character in value)
+            hash = HashValue(hash, character);
+
+        // Separates the strings so that for example "ab" + "c" and "a" + "bc" hash differently
+        return HashValue(hash, value.Length);
+    }
+
+    private ulong CalculateHash()
+    {
+        ulong hash = FNV_OFFSET_BASIS;
+
+        hash = HashValue(hash, MembraneType);
+        hash = HashValue(hash, IsBacteria ? 1 : 0);
+        hash = HashValue(hash, BitConverter.ToInt32(BitConverter.GetBytes(MembraneRigidity), 0));
+
+        foreach (var entry in organelles)
+        {
+            hash = HashValue(hash, entry.Name);
+            hash = HashValue(hash, entry.Position.Q);
+            hash = HashValue(hash, entry.Position.R);
+            hash = HashValue(hash, entry.Orientation);
+        }
+
+        return hash;
+    }
+
+    private struct OrganelleEntry : IComparable<OrganelleEntry>
+    {
+        public readonly string Name;
+        public readonly int Orientation;
+        public Hex Position;
+
+        public OrganelleEntry(string name, Hex position, int orientation)
+        {
+            Name = name;
+            Position = position;
+            Orientation = orientation;
+        }
+
+        public int CompareTo(OrganelleEntry other)
+        {
+            int result = Position.Q.CompareTo(other.Position.Q);
+
+            if (result == 0)
+                result = Position.R.CompareTo(other.Position.R);
+
+            if (result == 0)
+                result = string.CompareOrdinal(Name, other.Name);
+
+            if (result == 0)
+                result = Orientation.CompareTo(other.Orientation);
+
+            return result;
+        }
+    }
+}
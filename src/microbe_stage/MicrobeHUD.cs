@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Globalization;
 using Godot;
 using Array = Godot.Collections.Array;
@@ -152,6 +153,11 @@ public class MicrobeHUD : Node
     private readonly Compound phosphates = SimulationParameters.Instance.GetCompound("phosphates");
     private readonly Compound sunlight = SimulationParameters.Instance.GetCompound("sunlight");
 
+    /// <summary>
+    ///   Reused by UpdateHoverInfo for the compounds under the cursor
+    /// </summary>
+    private readonly Dictionary<Compound, float> hoveredCompounds = new Dictionary<Compound, float>();
+
     private AnimationPlayer animationPlayer;
     private MarginContainer mouseHoverPanel;
     private VBoxContainer hoveredCompoundsContainer;
@@ -602,7 +608,10 @@ public class MicrobeHUD : Node
         if (mouseHoverPanel.MarginRight != 0)
             mouseHoverPanel.MarginRight = 0;
 
-        var compounds = stage.Clouds.GetAllAvailableAt(stage.Camera.CursorWorldPos);
+        // The HUD keeps running while the stage is paused, so this can't use the stage frame arena
+        var compounds = hoveredCompounds;
+        compounds.Clear();
+        stage.Clouds.GetAllAvailableAt(stage.Camera.CursorWorldPos, compounds);
 
         var container = mouseHoverPanel.GetNode("PanelContainer/MarginContainer/VBoxContainer");
         var mousePosLabel = container.GetNode<Label>("MousePos");
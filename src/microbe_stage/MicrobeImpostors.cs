@@ -0,0 +1,54 @@
+using Godot;
+
+/// <summary>
+///   The shared material and the meshes of the impostors that are drawn in place of distant microbes. All
+///   impostors use the same material, the colour of each one is in the vertex colours of its own small mesh so
+///   that no per colour materials pile up as species change colour.
+/// </summary>
+public static class MicrobeImpostors
+{
+    private static ShaderMaterial material;
+    private static Godot.Collections.Array quadArrays;
+
+    /// <summary>
+    ///   The material of all impostors
+    /// </summary>
+    public static ShaderMaterial Material
+    {
+        get
+        {
+            if (material == null)
+                material = new ShaderMaterial { Shader = GD.Load<Shader>("res://shaders/MicrobeImpostor.shader") };
+
+            return material;
+        }
+    }
+
+    /// <summary>
+    ///   Creates a unit sized quad facing up in the colour of a species, scale it to the size of the microbe
+    /// </summary>
+    public static ArrayMesh CreateMesh(Color colour)
+    {
+        if (quadArrays == null)
+            quadArrays = new QuadMesh { Size = new Vector2(1, 1) }.GetMeshArrays();
+
+        // Desaturated the same way as the membrane tint so the colour doesn't change when switching to the
+        // impostor
+        colour.ToHsv(out var hue, out var saturation, out var brightness);
+        var tint = Color.FromHsv(hue, saturation * 0.75f, brightness);
+
+        var vertexCount = ((Vector3[])quadArrays[(int)Mesh.ArrayType.Vertex]).Length;
+        var colours = new Color[vertexCount];
+
+        for (int i = 0; i < vertexCount; ++i)
+            colours[i] = tint;
+
+        var arrays = quadArrays.Duplicate();
+        arrays[(int)Mesh.ArrayType.Color] = colours;
+
+        var mesh = new ArrayMesh();
+        mesh.AddSurfaceFromArrays(Mesh.PrimitiveType.Triangles, arrays);
+        mesh.SurfaceSetMaterial(0, Material);
+        return mesh;
+    }
+}
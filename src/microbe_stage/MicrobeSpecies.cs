@@ -16,6 +16,8 @@ public class MicrobeSpecies : Species
     public MembraneType MembraneType;
     public float MembraneRigidity;
 
+    private MicrobeGenome genome;
+
     public MicrobeSpecies(uint id)
         : base(id)
     {
@@ -24,6 +26,21 @@ public class MicrobeSpecies : Species
 
     public OrganelleLayout<OrganelleTemplate> Organelles { get; set; }
 
+    /// <summary>
+    ///   The interned canonical form of the organelles and membrane. Call UpdateGenome after changing those.
+    /// </summary>
+    [JsonIgnore]
+    public MicrobeGenome Genome
+    {
+        get
+        {
+            if (genome == null)
+                UpdateGenome();
+
+            return genome;
+        }
+    }
+
     [JsonIgnore]
     public override string StringCode
     {
@@ -75,6 +92,14 @@ public class MicrobeSpecies : Species
         }
     }
 
+    /// <summary>
+    ///   Recalculates the genome, needs to be called after the organelles or the membrane have been changed
+    /// </summary>
+    public void UpdateGenome()
+    {
+        genome = MicrobeGenome.Intern(MicrobeGenome.FromSpecies(this));
+    }
+
     public override void ApplyMutation(Species mutation)
     {
         base.ApplyMutation(mutation);
@@ -91,6 +116,8 @@ public class MicrobeSpecies : Species
         IsBacteria = casted.IsBacteria;
         MembraneType = casted.MembraneType;
         MembraneRigidity = casted.MembraneRigidity;
+
+        UpdateGenome();
     }
 
     public override object Clone()
@@ -108,6 +135,9 @@ public class MicrobeSpecies : Species
             result.Organelles.Add((OrganelleTemplate)organelle.Clone());
         }
 
+        // The genome is immutable so it can be shared
+        result.genome = genome;
+
         return result;
     }
 }
@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using Godot;
 using Newtonsoft.Json;
 
@@ -7,7 +8,7 @@ using Newtonsoft.Json;
 ///   Main class for managing the microbe stage
 /// </summary>
 [JsonObject(IsReference = true)]
-public class MicrobeStage : Node, ILoadableGameState
+public class MicrobeStage : Node, ILoadableGameState, IMemoryReporter
 {
     [Export]
     public NodePath GuidanceLinePath;
@@ -17,6 +18,13 @@ public class MicrobeStage : Node, ILoadableGameState
 
     private readonly Compound glucose = SimulationParameters.Instance.GetCompound("glucose");
 
+    /// <summary>
+    ///   Used to time the systems for the quality governor
+    /// </summary>
+    private readonly Stopwatch systemStopwatch = new Stopwatch();
+
+    private readonly FirstFramesTimer firstFramesTimer = new FirstFramesTimer("Microbe stage");
+
     private Node world;
     private Node rootOfDynamicallySpawned;
 
@@ -87,6 +95,24 @@ public class MicrobeStage : Node, ILoadableGameState
     [JsonIgnore]
     public ProcessSystem ProcessSystem { get; private set; }
 
+    [JsonIgnore]
+    public SimulationTierSystem SimulationTiers { get; private set; }
+
+    [JsonIgnore]
+    public MicrobeVisualDetailSystem VisualDetail { get; private set; }
+
+    /// <summary>
+    ///   Collections borrowed for the current frame, they are all given back at the start of the next frame
+    /// </summary>
+    [JsonIgnore]
+    public CollectionArena FrameArena { get; } = new CollectionArena();
+
+    /// <summary>
+    ///   The planar physics, null when the normal Godot physics is used
+    /// </summary>
+    [JsonIgnore]
+    public PlanarPhysicsSystem PlanarPhysics { get; private set; }
+
     /// <summary>
     ///   The main current game object holding various details
     /// </summary>
@@ -145,6 +171,15 @@ public class MicrobeStage : Node, ILoadableGameState
     [JsonIgnore]
     public bool TransitionFinished { get; internal set; }
 
+    [JsonIgnore]
+    public SpawnSystem Spawner => spawner;
+
+    /// <summary>
+    ///   True when the player species has gone extinct
+    /// </summary>
+    [JsonIgnore]
+    public bool GameOver => gameOver;
+
     /// <summary>
     ///   This should get called the first time the stage scene is put
     ///   into an active scene tree. So returning from the editor
@@ -164,9 +199,14 @@ public class MicrobeStage : Node, ILoadableGameState
         pauseMenu = GetNode<PauseMenu>(PauseMenuPath);
         TimedLifeSystem = new TimedLifeSystem(rootOfDynamicallySpawned);
         ProcessSystem = new ProcessSystem(rootOfDynamicallySpawned);
-        microbeAISystem = new MicrobeAISystem(rootOfDynamicallySpawned);
+        SimulationTiers = new SimulationTierSystem(rootOfDynamicallySpawned);
+        VisualDetail = new MicrobeVisualDetailSystem(rootOfDynamicallySpawned);
+        microbeAISystem = new MicrobeAISystem(rootOfDynamicallySpawned, Clouds, FrameArena);
         FluidSystem = new FluidSystem(rootOfDynamicallySpawned);
 
+        if (Settings.Instance.PlanarPhysics)
+            PlanarPhysics = new PlanarPhysicsSystem(rootOfDynamicallySpawned);
+
         tutorialGUI.Visible = true;
         HUD.Init(this);
 
@@ -287,7 +327,7 @@ public class MicrobeStage : Node, ILoadableGameState
         if (spawnedPlayer)
         {
             // Random location on respawn
-            var random = new Random();
+            var random = SimulationRandom.Create();
             Player.Translation = new Vector3(
                 random.Next(Constants.MIN_SPAWN_DISTANCE, Constants.MAX_SPAWN_DISTANCE), 0,
                 random.Next(Constants.MIN_SPAWN_DISTANCE, Constants.MAX_SPAWN_DISTANCE));
@@ -301,11 +341,26 @@ public class MicrobeStage : Node, ILoadableGameState
 
     public override void _PhysicsProcess(float delta)
     {
+        systemStopwatch.Restart();
+        var allocationStart = AllocationTracker.Instance.BeginMeasure();
+
         FluidSystem.PhysicsProcess(delta);
+        PlanarPhysics?.PhysicsProcess(delta);
+
+        QualityGovernor.Instance.ReportSystemTime(QualityGovernor.GovernedSystem.Physics,
+            (float)systemStopwatch.Elapsed.TotalMilliseconds);
+        AllocationTracker.Instance.EndMeasure(QualityGovernor.GovernedSystem.Physics, allocationStart);
     }
 
     public override void _Process(float delta)
     {
+        // The stage is processed before its child nodes so everything borrowed during the last frame is done
+        FrameArena.Reset();
+
+        QualityGovernor.Instance.Update(delta);
+        AllocationTracker.Instance.Update();
+        firstFramesTimer.Frame(delta);
+
         FluidSystem.Process(delta);
         TimedLifeSystem.Process(delta);
         ProcessSystem.Process(delta);
@@ -324,7 +379,16 @@ public class MicrobeStage : Node, ILoadableGameState
 
         if (Player != null)
         {
+            systemStopwatch.Restart();
+            var allocationStart = AllocationTracker.Instance.BeginMeasure();
             spawner.Process(delta, Player.Translation, Player.Rotation);
+            QualityGovernor.Instance.ReportSystemTime(QualityGovernor.GovernedSystem.Spawning,
+                (float)systemStopwatch.Elapsed.TotalMilliseconds);
+            AllocationTracker.Instance.EndMeasure(QualityGovernor.GovernedSystem.Spawning, allocationStart);
+
+            SimulationTiers.Process(delta, Player.Translation);
+            VisualDetail.Process(delta, Camera.GlobalTransform.origin, Player);
+
             Clouds.ReportPlayerPosition(Player.Translation);
 
             TutorialState.SendEvent(TutorialEventType.MicrobePlayerOrientation,
@@ -437,6 +501,7 @@ public class MicrobeStage : Node, ILoadableGameState
     /// </summary>
     public void OnReturnFromEditor()
     {
+        firstFramesTimer.Restart();
         UpdatePatchSettings(false);
 
         // Now the editor increases the generation so we don't do that here anymore
@@ -475,6 +540,48 @@ public class MicrobeStage : Node, ILoadableGameState
         TutorialState.SendEvent(TutorialEventType.EnteredMicrobeStage, EventArgs.Empty, this);
     }
 
+    public void ReportMemory(MemoryReport report)
+    {
+        // A stage loaded from a save for returning from the editor isn't set up
+        if (rootOfDynamicallySpawned == null)
+            return;
+
+        foreach (Node entity in rootOfDynamicallySpawned.GetChildren())
+        {
+            switch (entity)
+            {
+                case Microbe microbe:
+                    report.Add("Entities", "microbes", 0);
+                    report.Add("Entities", "membrane meshes", microbe.Membrane?.MeshBytes ?? 0);
+
+                    if (report.IncludeNodeCounts)
+                        report.Add("Entities", "microbe nodes", 0, MemoryReport.CountNodes(microbe));
+
+                    break;
+                case FloatingChunk chunk:
+                    report.Add("Entities", "chunks", 0);
+
+                    if (report.IncludeNodeCounts)
+                        report.Add("Entities", "chunk nodes", 0, MemoryReport.CountNodes(chunk));
+
+                    break;
+                default:
+                    if (report.IncludeNodeCounts)
+                        report.Add("Entities", "other nodes", 0, MemoryReport.CountNodes(entity));
+
+                    break;
+            }
+        }
+
+        report.Add("Rendering", "shared membrane materials", 0, MembraneMaterials.Count);
+
+        report.Add("Stage", "frame arena collections", 0, FrameArena.PooledCount);
+
+        Clouds.ReportMemory(report);
+        PlanarPhysics?.ReportMemory(report);
+        GameWorld.ReportMemory(report);
+    }
+
     private void CreatePatchManagerIfNeeded()
     {
         if (patchManager != null)
@@ -592,7 +699,8 @@ public class MicrobeStage : Node, ILoadableGameState
                 case AgentProjectile casted:
                 {
                     var spawned = SpawnHelpers.SpawnAgent(casted.Properties, casted.Amount, casted.TimeToLiveRemaining,
-                        casted.Translation, Vector3.Forward, rootOfDynamicallySpawned, agentScene, null);
+                        casted.Translation, Vector3.Forward, rootOfDynamicallySpawned, agentScene, null,
+                        random);
                     spawned.ApplyPropertiesFromSave(casted);
 
                     // TODO: mapping from old microbe to recreated microbe to set emitter here
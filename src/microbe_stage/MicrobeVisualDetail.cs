@@ -0,0 +1,20 @@
+/// <summary>
+///   How detailed a microbe is drawn, see MicrobeVisualDetailSystem
+/// </summary>
+public enum MicrobeVisualDetail
+{
+    /// <summary>
+    ///   Full membrane and the organelles
+    /// </summary>
+    Full,
+
+    /// <summary>
+    ///   Membrane mesh with fewer points and no organelles
+    /// </summary>
+    Reduced,
+
+    /// <summary>
+    ///   Only a flat quad in the species colour
+    /// </summary>
+    Impostor,
+}
@@ -0,0 +1,86 @@
+using Godot;
+
+/// <summary>
+///   Picks how detailed each microbe is drawn based on its distance to the camera, so that zoomed out views with
+///   lots of cells are cheap to render
+/// </summary>
+/// <remarks>
+///   <para>
+///     The distance is measured from the camera itself, so it works like the size of the cell on the screen:
+///     zooming out makes all the cells smaller and less detailed, and zooming in brings the detail back. The
+///     limits are set so that at the default zoom everything on the screen is drawn in full detail.
+///   </para>
+/// </remarks>
+public class MicrobeVisualDetailSystem
+{
+    private readonly Node worldRoot;
+
+    private float elapsed;
+
+    public MicrobeVisualDetailSystem(Node worldRoot)
+    {
+        this.worldRoot = worldRoot;
+    }
+
+    public int FullCount { get; private set; }
+
+    public int ReducedCount { get; private set; }
+
+    public int ImpostorCount { get; private set; }
+
+    /// <summary>
+    ///   Updates the detail levels of the microbes
+    /// </summary>
+    /// <param name="delta">Elapsed time in seconds</param>
+    /// <param name="cameraPosition">Position of the camera</param>
+    /// <param name="player">The player microbe, which is always drawn in full detail. May be null.</param>
+    public void Process(float delta, Vector3 cameraPosition, Microbe player)
+    {
+        elapsed += delta;
+
+        if (elapsed < Constants.MICROBE_VISUAL_DETAIL_UPDATE_INTERVAL)
+            return;
+
+        elapsed = 0;
+
+        int full = 0;
+        int reduced = 0;
+        int impostor = 0;
+
+        foreach (Node entity in worldRoot.GetTree().GetNodesInGroup(Constants.AI_TAG_MICROBE))
+        {
+            if (!(entity is Microbe microbe))
+                continue;
+
+            if (microbe == player)
+            {
+                microbe.VisualDetail = MicrobeVisualDetail.Full;
+                ++full;
+                continue;
+            }
+
+            float distanceSquared = microbe.Translation.DistanceSquaredTo(cameraPosition);
+
+            if (distanceSquared < Constants.MICROBE_FULL_DETAIL_DISTANCE * Constants.MICROBE_FULL_DETAIL_DISTANCE)
+            {
+                microbe.VisualDetail = MicrobeVisualDetail.Full;
+                ++full;
+            }
+            else if (distanceSquared <
+                Constants.MICROBE_REDUCED_DETAIL_DISTANCE * Constants.MICROBE_REDUCED_DETAIL_DISTANCE)
+            {
+                microbe.VisualDetail = MicrobeVisualDetail.Reduced;
+                ++reduced;
+            }
+            else
+            {
+                microbe.VisualDetail = MicrobeVisualDetail.Impostor;
+                ++impostor;
+            }
+        }
+
+        FullCount = full;
+        ReducedCount = reduced;
+        ImpostorCount = impostor;
+    }
+}
@@ -121,9 +121,10 @@ public class OrganelleDefinition : IRegistryType
     public bool ShouldScale = true;
 
     /// <summary>
-    ///   Caches the rotated hexes
+    ///   The rotated hexes for each of the 6 rotations. Filled in Resolve and only read after that, so this can be
+    ///   used from multiple threads, for example by the parallel auto-evo worlds.
     /// </summary>
-    private Dictionary<int, List<Hex>> rotatedHexesCache = new Dictionary<int, List<Hex>>();
+    private List<Hex>[] rotatedHexes;
 
     /// <summary>
     ///   The total amount of compounds in InitialComposition
@@ -158,21 +159,14 @@ public class OrganelleDefinition : IRegistryType
     public IEnumerable<Hex> GetRotatedHexes(int rotation)
     {
         // The rotations repeat every 6 steps
-        rotation = rotation % 6;
+        rotation = (rotation % 6 + 6) % 6;
 
-        if (!rotatedHexesCache.ContainsKey(rotation))
-        {
-            var rotated = new List<Hex>();
-
-            foreach (var hex in Hexes)
-            {
-                rotated.Add(Hex.RotateAxialNTimes(hex, rotation));
-            }
+        // Before Resolve the hexes are rotated each time, the cache is not written here as that would not be
+        // thread safe
+        if (rotatedHexes == null)
+            return CreateRotatedHexes(rotation);
 
-            rotatedHexesCache[rotation] = rotated;
-        }
-
-        return rotatedHexesCache[rotation];
+        return rotatedHexes[rotation];
     }
 
     public Vector3 CalculateCenterOffset()
@@ -319,10 +313,26 @@ public class OrganelleDefinition : IRegistryType
         }
 
         // Precompute rotations
+        var rotations = new List<Hex>[6];
+
         for (int i = 0; i < 6; ++i)
         {
-            GetRotatedHexes(i);
+            rotations[i] = CreateRotatedHexes(i);
+        }
+
+        rotatedHexes = rotations;
+    }
+
+    private List<Hex> CreateRotatedHexes(int rotation)
+    {
+        var rotated = new List<Hex>();
+
+        foreach (var hex in Hexes)
+        {
+            rotated.Add(Hex.RotateAxialNTimes(hex, rotation));
         }
+
+        return rotated;
     }
 
     public class OrganelleComponentFactoryInfo
@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Globalization;
+using System.Linq;
 using Godot;
 
 /// <summary>
@@ -17,6 +18,17 @@ public class PatchManager
 
     private Patch previousPatch;
 
+    /// <summary>
+    ///   True when the clouds of the current patch were restored, then the new cloud spawners wait for a while
+    /// </summary>
+    private bool cloudsRestored;
+
+    /// <summary>
+    ///   The microbes that were in the current patch when the player left it, spawned back by the new spawners.
+    ///   Null when the patch had no snapshot.
+    /// </summary>
+    private Dictionary<uint, int> restoredMicrobes;
+
     // Currently active spawns
     private List<CreatedSpawner> chunkSpawners = new List<CreatedSpawner>();
     private List<CreatedSpawner> cloudSpawners = new List<CreatedSpawner>();
@@ -53,6 +65,10 @@ public class PatchManager
                 GD.Print("Previous patch doesn't exist, despawning all entities.");
             }
 
+            // Keep the clouds of the patch that is left so that they are there when coming back
+            if (previousPatch != null)
+                StoreSnapshot(previousPatch);
+
             // Despawn old entities
             spawnSystem.DespawnAll();
 
@@ -61,6 +77,8 @@ public class PatchManager
 
             // Clear compounds
             compoundCloudSystem.EmptyAllClouds();
+
+            cloudsRestored = RestoreSnapshot(currentPatch);
         }
 
         previousPatch = currentPatch;
@@ -80,11 +98,47 @@ public class PatchManager
         HandleCellSpawns(currentPatch);
 
         RemoveNonMarkedSpawners();
+        cloudsRestored = false;
+        restoredMicrobes = null;
 
         // Change the lighting
         UpdateLight(currentPatch.BiomeTemplate);
     }
 
+    private void StoreSnapshot(Patch patch)
+    {
+        var snapshot = new PatchSnapshot
+        {
+            Clouds = compoundCloudSystem.CreateSnapshot(),
+            Microbes = spawnSystem.CountSpawnedMicrobes(),
+        };
+
+        currentGame.GameWorld.PatchSnapshots.Store(patch.ID, snapshot);
+
+        GD.Print("Stored the clouds and ", snapshot.Microbes.Values.Sum(), " microbes of patch (", patch.Name,
+            "), ", snapshot.Bytes / 1024, " KiB");
+    }
+
+    private bool RestoreSnapshot(Patch patch)
+    {
+        var snapshot = currentGame.GameWorld.PatchSnapshots.Take(patch.ID);
+
+        if (snapshot == null)
+            return false;
+
+        // The microbes can be brought back even if the clouds can't
+        restoredMicrobes = snapshot.Microbes;
+
+        if (!compoundCloudSystem.ApplySnapshot(snapshot.Clouds))
+        {
+            GD.Print("The stored clouds of patch (", patch.Name, ") don't match the current clouds");
+            return false;
+        }
+
+        GD.Print("Restored the clouds of patch (", patch.Name, ")");
+        return true;
+    }
+
     private void HandleChunkSpawns(BiomeConditions biome)
     {
         GD.Print("Number of chunks in this patch = ", biome.Chunks.Count);
@@ -111,7 +165,7 @@ public class PatchManager
 
         foreach (var entry in biome.Compounds)
         {
-            HandleSpawnHelper(chunkSpawners, entry.Key.InternalName, entry.Value.Density,
+            var created = HandleSpawnHelper(chunkSpawners, entry.Key.InternalName, entry.Value.Density,
                 () =>
                 {
                     var spawner = new CreatedSpawner(entry.Key.InternalName);
@@ -121,6 +175,11 @@ public class PatchManager
                         Constants.CLOUD_SPAWN_RADIUS);
                     return spawner;
                 });
+
+            // The clouds are already there so they don't need to be spawned all at once. This applies to the
+            // reused spawners as well as the new ones.
+            if (created != null && cloudsRestored)
+                created.Spawner.PausedFor = Constants.PATCH_SNAPSHOT_CLOUD_SPAWN_DELAY;
         }
     }
 
@@ -144,7 +203,7 @@ public class PatchManager
 
             var name = species.ID.ToString(CultureInfo.InvariantCulture);
 
-            HandleSpawnHelper(chunkSpawners, name, density,
+            var created = HandleSpawnHelper(chunkSpawners, name, density,
                 () =>
                 {
                     var spawner = new CreatedSpawner(name);
@@ -155,16 +214,27 @@ public class PatchManager
                         Constants.MICROBE_SPAWN_RADIUS);
                     return spawner;
                 });
+
+            // Bring back the microbes of this species that were around when the player left the patch
+            if (created != null && restoredMicrobes != null &&
+                restoredMicrobes.TryGetValue(species.ID, out int restoredCount))
+            {
+                created.Spawner.RestoredEntitiesLeft = restoredCount;
+            }
         }
     }
 
-    private void HandleSpawnHelper(List<CreatedSpawner> existingSpawners, string itemName,
+    /// <summary>
+    ///   Updates the existing spawner for an item or creates a new one
+    /// </summary>
+    /// <returns>The spawner of the item, null if the density doesn't allow spawning</returns>
+    private CreatedSpawner HandleSpawnHelper(List<CreatedSpawner> existingSpawners, string itemName,
         float density, Func<CreatedSpawner> createNew)
     {
         if (density <= 0)
         {
             GD.Print(itemName, " spawn density is 0. It won't spawn");
-            return;
+            return null;
         }
 
         var existing = existingSpawners.Find(s => s.Name == itemName);
@@ -181,14 +251,16 @@ public class PatchManager
                 GD.Print("Spawn frequency of ", existing.Name, " changed from ",
                     oldFrequency, " to ", existing.Spawner.SpawnFrequency);
             }
-        }
-        else
-        {
-            // New spawner needed
-            GD.Print("Registering new spawner: Name: ", itemName, " density: ", density);
 
-            existingSpawners.Add(createNew());
+            return existing;
         }
+
+        // New spawner needed
+        GD.Print("Registering new spawner: Name: ", itemName, " density: ", density);
+
+        var created = createNew();
+        existingSpawners.Add(created);
+        return created;
     }
 
     private void UpdateLight(Biome biome)
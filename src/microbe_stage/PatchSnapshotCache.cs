@@ -0,0 +1,118 @@
+using System.Collections.Generic;
+using System.Linq;
+using Godot;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Keeps the compound clouds and a summary of the microbes of the patches the player has left, so that they can
+///   be put back when the player returns instead of spawning again from nothing
+/// </summary>
+/// <remarks>
+///   <para>
+///     The snapshots are compressed and saved with the world. When they take more than MemoryCap bytes the least
+///     recently stored ones are dropped.
+///   </para>
+/// </remarks>
+public class PatchSnapshotCache
+{
+    [JsonProperty]
+    private Dictionary<int, PatchSnapshot> snapshots = new Dictionary<int, PatchSnapshot>();
+
+    private long memoryCap = Constants.PATCH_SNAPSHOT_MEMORY_CAP;
+
+    /// <summary>
+    ///   Increases on each store, used to find the least recently used snapshot
+    /// </summary>
+    [JsonProperty]
+    private long useCounter;
+
+    /// <summary>
+    ///   Bytes the snapshots may take in total. Lowering this drops the least recently stored snapshots right away.
+    /// </summary>
+    [JsonProperty]
+    public long MemoryCap
+    {
+        get => memoryCap;
+        set
+        {
+            memoryCap = value;
+            EvictOverCap();
+        }
+    }
+
+    [JsonIgnore]
+    public int Count => snapshots.Count;
+
+    [JsonIgnore]
+    public long TotalBytes => snapshots.Values.Sum(snapshot => snapshot.Bytes);
+
+    /// <summary>
+    ///   Stores the state of a patch, replacing an earlier snapshot of it
+    /// </summary>
+    public void Store(int patchId, PatchSnapshot snapshot)
+    {
+        snapshot.LastUsed = ++useCounter;
+        snapshots[patchId] = snapshot;
+
+        EvictOverCap();
+    }
+
+    /// <summary>
+    ///   Removes and returns the snapshot of a patch, as the patch becomes the active one it is no longer valid
+    ///   after this
+    /// </summary>
+    /// <returns>The snapshot or null if there is none</returns>
+    public PatchSnapshot Take(int patchId)
+    {
+        if (!snapshots.TryGetValue(patchId, out var snapshot))
+            return null;
+
+        snapshots.Remove(patchId);
+        return snapshot;
+    }
+
+    public void Clear()
+    {
+        snapshots.Clear();
+    }
+
+    private void EvictOverCap()
+    {
+        long total = TotalBytes;
+
+        while (total > memoryCap && snapshots.Count > 0)
+        {
+            var oldest = snapshots.OrderBy(entry => entry.Value.LastUsed).First();
+
+            GD.Print("Dropping the snapshot of patch ", oldest.Key, " to stay under the memory cap");
+
+            total -= oldest.Value.Bytes;
+            snapshots.Remove(oldest.Key);
+        }
+    }
+}
+
+/// <summary>
+///   The state of a patch when the player left it
+/// </summary>
+public class PatchSnapshot
+{
+    /// <summary>
+    ///   Compressed cloud contents from CompoundCloudSystem.CreateSnapshot
+    /// </summary>
+    [JsonProperty]
+    public byte[] Clouds { get; set; }
+
+    /// <summary>
+    ///   How many microbes of each species (by ID) were around the player when the patch was left, these are
+    ///   spawned back first when the player returns
+    /// </summary>
+    [JsonProperty]
+    public Dictionary<uint, int> Microbes { get; set; } = new Dictionary<uint, int>();
+
+    [JsonProperty]
+    public long LastUsed { get; set; }
+
+    [JsonIgnore]
+    public long Bytes => (Clouds?.LongLength ?? 0) + (Microbes?.Count ?? 0) * (sizeof(uint) + sizeof(int));
+}
@@ -0,0 +1,633 @@
+using System;
+using System.Collections.Generic;
+using Godot;
+
+/// <summary>
+///   Optional 2D physics backend for the microbe stage entities. As everything in the stage happens on a single
+///   plane, this can be a lot simpler than the full 3D physics server.
+/// </summary>
+/// <remarks>
+///   <para>
+///     Bodies are circles stored as structure of arrays. The broadphase is a hashed uniform grid that is rebuilt
+///     each step with a counting sort, so no memory is allocated once the arrays have grown large enough.
+///     Godot bodies that are simulated by this are switched to kinematic mode, and this writes their positions
+///     back after each step. Entities opt in by being in Constants.PLANAR_PHYSICS_GROUP and implementing
+///     IPlanarPhysicsBody.
+///   </para>
+///   <para>
+///     The group isn't queried each step as that allocates a new array. Instead the entities add themselves to a
+///     list when they enter the scene tree and remove themselves when they exit it, and each step goes through
+///     that list.
+///   </para>
+/// </remarks>
+public class PlanarPhysicsSystem : IMemoryReporter
+{
+    private const int INITIAL_CAPACITY = 256;
+
+    /// <summary>
+    ///   The IPlanarPhysicsBody entities in the scene tree. A list to keep the order the same between runs.
+    ///   Only used on the main thread.
+    /// </summary>
+    private static readonly List<IPlanarPhysicsBody> EntitiesInTree = new List<IPlanarPhysicsBody>();
+
+    private readonly Node worldRoot;
+
+    private readonly Stack<int> freeIndices = new Stack<int>();
+
+    private readonly List<long> removedContacts = new List<long>();
+
+    /// <summary>
+    ///   Contacts touching in the previous and current step, keyed by the index pair
+    /// </summary>
+    private HashSet<long> previousContacts = new HashSet<long>();
+    private HashSet<long> currentContacts = new HashSet<long>();
+
+    // Body data
+    private bool[] used;
+    private float[] positionX;
+    private float[] positionY;
+    private float[] velocityX;
+    private float[] velocityY;
+    private float[] inverseMass;
+    private float[] radius;
+    private float[] damping;
+    private uint[] collisionLayer;
+    private uint[] collisionMask;
+    private Spatial[] nodes;
+    private IPlanarPhysicsBody[] owners;
+    private int[] lastSeenStep;
+
+    /// <summary>
+    ///   One past the highest used body index
+    /// </summary>
+    private int bodyCount;
+
+    // Broadphase data
+    private int[] bucketStarts = new int[Constants.PLANAR_PHYSICS_GRID_BUCKETS + 1];
+    private int[] bucketFill = new int[Constants.PLANAR_PHYSICS_GRID_BUCKETS];
+    private int[] entryBody = new int[INITIAL_CAPACITY * 4];
+    private int[] entryCellX = new int[INITIAL_CAPACITY * 4];
+    private int[] entryCellY = new int[INITIAL_CAPACITY * 4];
+
+    // Narrowphase results
+    private int contactCount;
+    private int[] contactA = new int[INITIAL_CAPACITY];
+    private int[] contactB = new int[INITIAL_CAPACITY];
+    private float[] contactNormalX = new float[INITIAL_CAPACITY];
+    private float[] contactNormalY = new float[INITIAL_CAPACITY];
+    private float[] contactPenetration = new float[INITIAL_CAPACITY];
+
+    private int stepNumber;
+
+    public PlanarPhysicsSystem(Node worldRoot)
+    {
+        this.worldRoot = worldRoot;
+        Resize(INITIAL_CAPACITY);
+    }
+
+    /// <summary>
+    ///   The number of currently simulated bodies
+    /// </summary>
+    public int ActiveBodies => bodyCount - freeIndices.Count;
+
+    /// <summary>
+    ///   The number of touching body pairs in the last step
+    /// </summary>
+    public int ActiveContacts => currentContacts.Count;
+
+    /// <summary>
+    ///   Called by the IPlanarPhysicsBody entities in _EnterTree
+    /// </summary>
+    public static void OnEntityEnteredTree(IPlanarPhysicsBody entity)
+    {
+        EntitiesInTree.Add(entity);
+    }
+
+    /// <summary>
+    ///   Called by the IPlanarPhysicsBody entities in _ExitTree
+    /// </summary>
+    public static void OnEntityExitedTree(IPlanarPhysicsBody entity)
+    {
+        EntitiesInTree.Remove(entity);
+    }
+
+    /// <summary>
+    ///   Syncs the bodies with the entities in the planar physics group and then runs one step
+    /// </summary>
+    public void PhysicsProcess(float delta)
+    {
+        ++stepNumber;
+
+        for (int i = 0; i < EntitiesInTree.Count; ++i)
+        {
+            var planar = EntitiesInTree[i];
+
+            if (!(planar is RigidBody body))
+            {
+                GD.PrintErr("An IPlanarPhysicsBody entity isn't a RigidBody");
+                continue;
+            }
+
+            // Other stages or benchmarks may have entities in the tree at the same time
+            if (!body.IsInGroup(Constants.PLANAR_PHYSICS_GROUP) || !worldRoot.IsAParentOf(body))
+                continue;
+
+            SyncEntity(body, planar);
+        }
+
+        // Anything not in the group anymore is removed
+        for (int i = 0; i < bodyCount; ++i)
+        {
+            if (used[i] && owners[i] != null && lastSeenStep[i] != stepNumber)
+                RemoveBody(i);
+        }
+
+        Step(delta);
+    }
+
+    /// <summary>
+    ///   Adds a body that isn't an entity. This is used by the benchmark.
+    /// </summary>
+    /// <param name="node">Node whose translation is updated from this body, can be null</param>
+    /// <returns>The index of the added body</returns>
+    public int AddBody(Spatial node, Vector2 position, Vector2 velocity, float bodyRadius, float mass,
+        float linearDamp, uint layer = 1, uint mask = 1)
+    {
+        int index;
+
+        if (freeIndices.Count > 0)
+        {
+            index = freeIndices.Pop();
+        }
+        else
+        {
+            if (bodyCount >= used.Length)
+                Resize(used.Length * 2);
+
+            index = bodyCount++;
+        }
+
+        used[index] = true;
+        positionX[index] = position.x;
+        positionY[index] = position.y;
+        velocityX[index] = velocity.x;
+        velocityY[index] = velocity.y;
+        inverseMass[index] = mass > 0 ? 1.0f / mass : 0;
+        radius[index] = bodyRadius;
+        damping[index] = linearDamp >= 0 ? linearDamp : Constants.PLANAR_PHYSICS_DEFAULT_LINEAR_DAMP;
+        collisionLayer[index] = layer;
+        collisionMask[index] = mask;
+        nodes[index] = node;
+        owners[index] = null;
+        lastSeenStep[index] = stepNumber;
+
+        return index;
+    }
+
+    /// <summary>
+    ///   Removes a body, sending contact end events to the bodies it was touching
+    /// </summary>
+    public void RemoveBody(int index)
+    {
+        if (!used[index])
+            throw new ArgumentException("body at index is not in use");
+
+        // End the contacts this was part of
+        foreach (var pair in currentContacts)
+        {
+            UnpackPair(pair, out int first, out int second);
+
+            if (first != index && second != index)
+                continue;
+
+            removedContacts.Add(pair);
+
+            var other = first == index ? second : first;
+
+            owners[other]?.OnPlanarContactEnd(owners[index]);
+        }
+
+        foreach (var pair in removedContacts)
+            currentContacts.Remove(pair);
+
+        removedContacts.Clear();
+
+        var owner = owners[index];
+
+        if (owner != null && Godot.Object.IsInstanceValid(nodes[index]))
+        {
+            // Give the body back to the normal physics
+            var body = (RigidBody)nodes[index];
+            owner.PlanarBodyIndex = -1;
+            body.Mode = RigidBody.ModeEnum.Rigid;
+            body.LinearVelocity = new Vector3(velocityX[index], 0, velocityY[index]);
+        }
+
+        used[index] = false;
+        nodes[index] = null;
+        owners[index] = null;
+        freeIndices.Push(index);
+    }
+
+    public Vector2 GetPosition(int index)
+    {
+        return new Vector2(positionX[index], positionY[index]);
+    }
+
+    public Vector2 GetVelocity(int index)
+    {
+        return new Vector2(velocityX[index], velocityY[index]);
+    }
+
+    public void ReportMemory(MemoryReport report)
+    {
+        // The node and owner arrays hold references
+        long bodyBytes = used.LongLength * (sizeof(bool) + sizeof(float) * 7 + sizeof(uint) * 2 + sizeof(int) +
+            IntPtr.Size * 2);
+
+        long broadphaseBytes = (bucketStarts.LongLength + bucketFill.LongLength + entryBody.LongLength +
+            entryCellX.LongLength + entryCellY.LongLength) * sizeof(int);
+
+        long contactBytes = (contactA.LongLength + contactB.LongLength) * sizeof(int) +
+            (contactNormalX.LongLength + contactNormalY.LongLength + contactPenetration.LongLength) * sizeof(float);
+
+        report.Add("Planar physics", "bodies", bodyBytes, ActiveBodies);
+        report.Add("Planar physics", "broadphase", broadphaseBytes);
+        report.Add("Planar physics", "contacts", contactBytes, ActiveContacts);
+    }
+
+    /// <summary>
+    ///   Runs a single simulation step and writes the new positions to the nodes
+    /// </summary>
+    public void Step(float delta)
+    {
+        Integrate(delta);
+        FindContacts();
+
+        for (int iteration = 0; iteration < Constants.PLANAR_PHYSICS_SOLVER_ITERATIONS; ++iteration)
+            SolveContacts();
+
+        CorrectPositions();
+        ReportContacts();
+
+        for (int i = 0; i < bodyCount; ++i)
+        {
+            if (!used[i] || nodes[i] == null)
+                continue;
+
+            nodes[i].Translation = new Vector3(positionX[i], Constants.CLOUD_Y_COORDINATE, positionY[i]);
+        }
+    }
+
+    private static long PackPair(int first, int second)
+    {
+        return ((long)first << 32) | (uint)second;
+    }
+
+    private static void UnpackPair(long pair, out int first, out int second)
+    {
+        first = (int)(pair >> 32);
+        second = (int)(pair & 0xffffffff);
+    }
+
+    private static int CellOf(float coordinate)
+    {
+        return (int)Math.Floor(coordinate / Constants.PLANAR_PHYSICS_GRID_CELL_SIZE);
+    }
+
+    private static int BucketOf(int cellX, int cellY)
+    {
+        unchecked
+        {
+            int hash = (cellX * 73856093) ^ (cellY * 19349663);
+            return (hash & int.MaxValue) % Constants.PLANAR_PHYSICS_GRID_BUCKETS;
+        }
+    }
+
+    /// <summary>
+    ///   Registers new entities and reads the properties that other code can change on existing ones
+    /// </summary>
+    private void SyncEntity(RigidBody body, IPlanarPhysicsBody planar)
+    {
+        var translation = body.Translation;
+        int index = planar.PlanarBodyIndex;
+
+        if (index < 0)
+        {
+            // Start simulating a new entity, the initial velocity is taken from the normal physics
+            var velocity = body.LinearVelocity;
+
+            index = AddBody(body, new Vector2(translation.x, translation.z), new Vector2(velocity.x, velocity.z),
+                planar.PlanarRadius, body.Mass, body.LinearDamp);
+
+            owners[index] = planar;
+            planar.PlanarBodyIndex = index;
+            body.Mode = RigidBody.ModeEnum.Kinematic;
+        }
+        else
+        {
+            // Someone else moved this entity (for example respawn or loading a save)
+            if (Math.Abs(translation.x - positionX[index]) > MathUtils.EPSILON ||
+                Math.Abs(translation.z - positionY[index]) > MathUtils.EPSILON)
+            {
+                positionX[index] = translation.x;
+                positionY[index] = translation.z;
+            }
+
+            radius[index] = planar.PlanarRadius;
+        }
+
+        var impulse = planar.QueuedPlanarImpulse;
+
+        if (impulse.x != 0 || impulse.z != 0)
+        {
+            velocityX[index] += impulse.x * inverseMass[index];
+            velocityY[index] += impulse.z * inverseMass[index];
+            planar.QueuedPlanarImpulse = new Vector3(0, 0, 0);
+        }
+
+        collisionLayer[index] = body.CollisionLayer;
+        collisionMask[index] = body.CollisionMask;
+        lastSeenStep[index] = stepNumber;
+    }
+
+    private void Integrate(float delta)
+    {
+        for (int i = 0; i < bodyCount; ++i)
+        {
+            if (!used[i])
+                continue;
+
+            float damp = Math.Max(1.0f - (delta * damping[i]), 0.0f);
+
+            velocityX[i] *= damp;
+            velocityY[i] *= damp;
+
+            positionX[i] += velocityX[i] * delta;
+            positionY[i] += velocityY[i] * delta;
+        }
+    }
+
+    /// <summary>
+    ///   Broadphase and narrowphase to find all overlapping circles
+    /// </summary>
+    private void FindContacts()
+    {
+        Array.Clear(bucketFill, 0, bucketFill.Length);
+
+        // Count the grid cell entries for each bucket
+        int entryCount = 0;
+
+        for (int i = 0; i < bodyCount; ++i)
+        {
+            if (!used[i] || (collisionLayer[i] == 0 && collisionMask[i] == 0))
+                continue;
+
+            GetCellRange(i, out int minX, out int minY, out int maxX, out int maxY);
+
+            for (int x = minX; x <= maxX; ++x)
+            {
+                for (int y = minY; y <= maxY; ++y)
+                {
+                    ++bucketFill[BucketOf(x, y)];
+                    ++entryCount;
+                }
+            }
+        }
+
+        if (entryCount > entryBody.Length)
+        {
+            int newSize = Math.Max(entryCount, entryBody.Length * 2);
+            entryBody = new int[newSize];
+            entryCellX = new int[newSize];
+            entryCellY = new int[newSize];
+        }
+
+        bucketStarts[0] = 0;
+
+        for (int bucket = 0; bucket < Constants.PLANAR_PHYSICS_GRID_BUCKETS; ++bucket)
+        {
+            bucketStarts[bucket + 1] = bucketStarts[bucket] + bucketFill[bucket];
+            bucketFill[bucket] = bucketStarts[bucket];
+        }
+
+        // Place the entries
+        for (int i = 0; i < bodyCount; ++i)
+        {
+            if (!used[i] || (collisionLayer[i] == 0 && collisionMask[i] == 0))
+                continue;
+
+            GetCellRange(i, out int minX, out int minY, out int maxX, out int maxY);
+
+            for (int x = minX; x <= maxX; ++x)
+            {
+                for (int y = minY; y <= maxY; ++y)
+                {
+                    int entry = bucketFill[BucketOf(x, y)]++;
+                    entryBody[entry] = i;
+                    entryCellX[entry] = x;
+                    entryCellY[entry] = y;
+                }
+            }
+        }
+
+        // Test pairs sharing a cell
+        contactCount = 0;
+
+        for (int bucket = 0; bucket < Constants.PLANAR_PHYSICS_GRID_BUCKETS; ++bucket)
+        {
+            int end = bucketStarts[bucket + 1];
+
+            for (int first = bucketStarts[bucket]; first < end; ++first)
+            {
+                for (int second = first + 1; second < end; ++second)
+                {
+                    // Different cells can hash to the same bucket
+                    if (entryCellX[first] != entryCellX[second] || entryCellY[first] != entryCellY[second])
+                        continue;
+
+                    TestPair(entryBody[first], entryBody[second], entryCellX[first], entryCellY[first]);
+                }
+            }
+        }
+    }
+
+    private void GetCellRange(int index, out int minX, out int minY, out int maxX, out int maxY)
+    {
+        minX = CellOf(positionX[index] - radius[index]);
+        minY = CellOf(positionY[index] - radius[index]);
+        maxX = CellOf(positionX[index] + radius[index]);
+        maxY = CellOf(positionY[index] + radius[index]);
+    }
+
+    private void TestPair(int a, int b, int cellX, int cellY)
+    {
+        if ((collisionLayer[a] & collisionMask[b]) == 0 && (collisionLayer[b] & collisionMask[a]) == 0)
+            return;
+
+        // Bodies sharing multiple cells are only tested in the first shared cell
+        GetCellRange(a, out int minXA, out int minYA, out _, out _);
+        GetCellRange(b, out int minXB, out int minYB, out _, out _);
+
+        if (cellX != Math.Max(minXA, minXB) || cellY != Math.Max(minYA, minYB))
+            return;
+
+        float dx = positionX[b] - positionX[a];
+        float dy = positionY[b] - positionY[a];
+        float radii = radius[a] + radius[b];
+        float distanceSquared = dx * dx + dy * dy;
+
+        if (distanceSquared >= radii * radii)
+            return;
+
+        var ownerA = owners[a];
+        var ownerB = owners[b];
+
+        if (ownerA != null && ownerB != null &&
+            (!ownerA.PlanarCollidesWith(ownerB) || !ownerB.PlanarCollidesWith(ownerA)))
+        {
+            return;
+        }
+
+        if (contactCount >= contactA.Length)
+            ResizeContacts(contactA.Length * 2);
+
+        float distance = (float)Math.Sqrt(distanceSquared);
+
+        contactA[contactCount] = a;
+        contactB[contactCount] = b;
+        contactPenetration[contactCount] = radii - distance;
+
+        if (distance > MathUtils.EPSILON)
+        {
+            contactNormalX[contactCount] = dx / distance;
+            contactNormalY[contactCount] = dy / distance;
+        }
+        else
+        {
+            // Exactly on top of each other, just pick a direction
+            contactNormalX[contactCount] = 1;
+            contactNormalY[contactCount] = 0;
+        }
+
+        ++contactCount;
+    }
+
+    private void SolveContacts()
+    {
+        for (int i = 0; i < contactCount; ++i)
+        {
+            int a = contactA[i];
+            int b = contactB[i];
+
+            float inverseMassSum = inverseMass[a] + inverseMass[b];
+
+            if (inverseMassSum <= 0)
+                continue;
+
+            float normalVelocity = (velocityX[b] - velocityX[a]) * contactNormalX[i] +
+                (velocityY[b] - velocityY[a]) * contactNormalY[i];
+
+            // Already separating
+            if (normalVelocity > 0)
+                continue;
+
+            float impulse = -(1.0f + Constants.PLANAR_PHYSICS_RESTITUTION) * normalVelocity / inverseMassSum;
+
+            velocityX[a] -= impulse * inverseMass[a] * contactNormalX[i];
+            velocityY[a] -= impulse * inverseMass[a] * contactNormalY[i];
+            velocityX[b] += impulse * inverseMass[b] * contactNormalX[i];
+            velocityY[b] += impulse * inverseMass[b] * contactNormalY[i];
+        }
+    }
+
+    /// <summary>
+    ///   Pushes overlapping bodies apart so that they don't sink into each other
+    /// </summary>
+    private void CorrectPositions()
+    {
+        for (int i = 0; i < contactCount; ++i)
+        {
+            int a = contactA[i];
+            int b = contactB[i];
+
+            float inverseMassSum = inverseMass[a] + inverseMass[b];
+
+            if (inverseMassSum <= 0)
+                continue;
+
+            float correction = Math.Max(contactPenetration[i] - Constants.PLANAR_PHYSICS_PENETRATION_SLOP, 0) /
+                inverseMassSum * Constants.PLANAR_PHYSICS_POSITION_CORRECTION;
+
+            positionX[a] -= correction * inverseMass[a] * contactNormalX[i];
+            positionY[a] -= correction * inverseMass[a] * contactNormalY[i];
+            positionX[b] += correction * inverseMass[b] * contactNormalX[i];
+            positionY[b] += correction * inverseMass[b] * contactNormalY[i];
+        }
+    }
+
+    /// <summary>
+    ///   Compares the contacts with the previous step to send the begin and end callbacks
+    /// </summary>
+    private void ReportContacts()
+    {
+        var swap = previousContacts;
+        previousContacts = currentContacts;
+        currentContacts = swap;
+        currentContacts.Clear();
+
+        for (int i = 0; i < contactCount; ++i)
+        {
+            int a = contactA[i];
+            int b = contactB[i];
+
+            var pair = a < b ? PackPair(a, b) : PackPair(b, a);
+
+            // The same pair is only found once per step
+            currentContacts.Add(pair);
+
+            if (!previousContacts.Contains(pair))
+            {
+                owners[a]?.OnPlanarContactBegin(owners[b]);
+                owners[b]?.OnPlanarContactBegin(owners[a]);
+            }
+        }
+
+        foreach (var pair in previousContacts)
+        {
+            if (currentContacts.Contains(pair))
+                continue;
+
+            UnpackPair(pair, out int a, out int b);
+
+            owners[a]?.OnPlanarContactEnd(owners[b]);
+            owners[b]?.OnPlanarContactEnd(owners[a]);
+        }
+    }
+
+    private void Resize(int capacity)
+    {
+        Array.Resize(ref used, capacity);
+        Array.Resize(ref positionX, capacity);
+        Array.Resize(ref positionY, capacity);
+        Array.Resize(ref velocityX, capacity);
+        Array.Resize(ref velocityY, capacity);
+        Array.Resize(ref inverseMass, capacity);
+        Array.Resize(ref radius, capacity);
+        Array.Resize(ref damping, capacity);
+        Array.Resize(ref collisionLayer, capacity);
+        Array.Resize(ref collisionMask, capacity);
+        Array.Resize(ref nodes, capacity);
+        Array.Resize(ref owners, capacity);
+        Array.Resize(ref lastSeenStep, capacity);
+    }
+
+    private void ResizeContacts(int capacity)
+    {
+        Array.Resize(ref contactA, capacity);
+        Array.Resize(ref contactB, capacity);
+        Array.Resize(ref contactNormalX, capacity);
+        Array.Resize(ref contactNormalY, capacity);
+        Array.Resize(ref contactPenetration, capacity);
+    }
+}
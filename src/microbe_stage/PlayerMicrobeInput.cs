@@ -1,8 +1,18 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
 using Godot;
+using Newtonsoft.Json;
 
 /// <summary>
 ///   Handles key input in the microbe stage
 /// </summary>
+/// <remarks>
+///   <para>
+///     The input is collected into InputRecording.Actions each frame, which allows recording it, or driving the
+///     stage from a recording instead of the real input. See CommandLineOptions for how to enable that.
+///   </para>
+/// </remarks>
 public class PlayerMicrobeInput : Node
 {
     /// <summary>
@@ -26,13 +36,57 @@ public class PlayerMicrobeInput : Node
     private bool cheatAmmonia;
     private bool cheatPhosphates;
 
+    /// <summary>
+    ///   Actions that happen once, collected from the input events until the next frame
+    /// </summary>
+    private InputRecording.Actions triggeredActions;
+
+    /// <summary>
+    ///   The recording being made, null if not recording
+    /// </summary>
+    private InputRecording recording;
+
+    /// <summary>
+    ///   The recording being replayed, null if not replaying
+    /// </summary>
+    private InputRecording replay;
+
+    private int replayFrame;
+
+    /// <summary>
+    ///   Real duration of each replayed frame in milliseconds, for comparing builds
+    /// </summary>
+    private List<float> replayFrameTimes;
+    private ulong lastReplayFrameTicks;
+
     public override void _Ready()
     {
         stage = (MicrobeStage)GetParent();
+
+        // Recording and replaying only make sense for new games. This happens before the stage sets up the game
+        // so the seed is used for the new world.
+        if (stage.IsLoadedFromSave)
+            return;
+
+        if (CommandLineOptions.ReplayInputPath != null)
+        {
+            StartReplay(CommandLineOptions.ReplayInputPath);
+        }
+        else if (CommandLineOptions.RecordInputPath != null)
+        {
+            var seed = new Random().Next();
+            SimulationRandom.SetWorldSeed(seed);
+            recording = new InputRecording(seed);
+
+            GD.Print("Recording player input with seed: ", seed);
+        }
     }
 
     public override void _UnhandledInput(InputEvent @event)
     {
+        if (replay != null)
+            return;
+
         var settings = Settings.Instance;
 
         if (@event.IsActionPressed("g_hold_forward") && autoMoveAllowed)
@@ -86,7 +140,7 @@ public class PlayerMicrobeInput : Node
 
         if (settings.CheatsEnabled && @event.IsActionPressed("g_cheat_editor"))
         {
-            stage.HUD.ShowReproductionDialog();
+            triggeredActions |= InputRecording.Actions.CheatEditor;
         }
 
         if (settings.CheatsEnabled && @event.IsActionPressed("g_cheat_glucose"))
@@ -118,15 +172,12 @@ public class PlayerMicrobeInput : Node
 
         if (@event.IsActionPressed("g_toggle_engulf"))
         {
-            if (stage.Player != null)
-            {
-                stage.Player.EngulfMode = !stage.Player.EngulfMode;
-            }
+            triggeredActions |= InputRecording.Actions.ToggleEngulf;
         }
 
         if (@event.IsActionPressed("g_fire_toxin", true))
         {
-            stage.Player?.EmitToxin();
+            triggeredActions |= InputRecording.Actions.FireToxin;
         }
     }
 
@@ -144,28 +195,88 @@ public class PlayerMicrobeInput : Node
                 right = false;
             }
         }
+
+        // The session ends when the stage is freed (not when it is temporarily detached for the editor) or the
+        // game is closed from the window
+        if (focus == NotificationPredelete || focus == MainLoop.NotificationWmQuitRequest)
+        {
+            StopRecording();
+
+            if (replay != null)
+                EndReplay();
+        }
     }
 
     public override void _Process(float delta)
     {
-        var movement = new Vector3(0, 0, 0);
+        InputRecording.Actions actions;
+        Vector2 cursor;
+
+        if (replay != null)
+        {
+            if (!ReadReplayFrame(delta, out actions, out cursor))
+                return;
+        }
+        else
+        {
+            actions = CollectActions();
+            cursor = new Vector2(stage.Camera.CursorWorldPos.x, stage.Camera.CursorWorldPos.z);
+
+            recording?.Frames.Add(new InputRecording.Frame(delta, actions, cursor));
+        }
+
+        ApplyActions(actions, new Vector3(cursor.x, 0, cursor.y), delta);
+    }
+
+    private InputRecording.Actions CollectActions()
+    {
+        var actions = triggeredActions;
+        triggeredActions = InputRecording.Actions.None;
 
         if (forward)
+            actions |= InputRecording.Actions.Forward;
+
+        if (backwards)
+            actions |= InputRecording.Actions.Backwards;
+
+        if (left)
+            actions |= InputRecording.Actions.Left;
+
+        if (right)
+            actions |= InputRecording.Actions.Right;
+
+        if (cheatGlucose)
+            actions |= InputRecording.Actions.CheatGlucose;
+
+        if (cheatAmmonia)
+            actions |= InputRecording.Actions.CheatAmmonia;
+
+        if (cheatPhosphates)
+            actions |= InputRecording.Actions.CheatPhosphates;
+
+        return actions;
+    }
+
+    private void ApplyActions(InputRecording.Actions actions, Vector3 cursor, float delta)
+    {
+        var movement = new Vector3(0, 0, 0);
+
+        if ((actions & InputRecording.Actions.Forward) != 0)
         {
             movement.z -= 1;
         }
 
-        if (backwards)
+        if ((actions & InputRecording.Actions.Backwards) != 0)
         {
             movement.z += 1;
         }
 
-        if (left)
+        if ((actions & InputRecording.Actions.Left) != 0)
         {
             movement.x -= 1;
         }
 
-        if (right)
+        if ((actions & InputRecording.Actions.Right) != 0)
         {
             movement.x += 1;
         }
@@ -173,28 +284,187 @@ public class PlayerMicrobeInput : Node
         if (stage.Player != null)
         {
             stage.Player.MovementDirection = movement.Normalized();
-            stage.Player.LookAtPoint = stage.Camera.CursorWorldPos;
+            stage.Player.LookAtPoint = cursor;
+
+            if ((actions & InputRecording.Actions.ToggleEngulf) != 0)
+                stage.Player.EngulfMode = !stage.Player.EngulfMode;
+
+            if ((actions & InputRecording.Actions.FireToxin) != 0)
+                stage.Player.EmitToxin();
         }
 
-        if (cheatAmmonia)
+        if ((actions & InputRecording.Actions.CheatEditor) != 0)
         {
-            SpawnCheatCloud("ammonia", delta);
+            stage.HUD.ShowReproductionDialog();
         }
 
-        if (cheatGlucose)
+        if ((actions & InputRecording.Actions.CheatAmmonia) != 0)
         {
-            SpawnCheatCloud("glucose", delta);
+            SpawnCheatCloud("ammonia", cursor, delta);
         }
 
-        if (cheatPhosphates)
+        if ((actions & InputRecording.Actions.CheatGlucose) != 0)
+        {
+            SpawnCheatCloud("glucose", cursor, delta);
+        }
+
+        if ((actions & InputRecording.Actions.CheatPhosphates) != 0)
         {
-            SpawnCheatCloud("phosphates", delta);
+            SpawnCheatCloud("phosphates", cursor, delta);
         }
     }
 
-    private void SpawnCheatCloud(string name, float delta)
+    private void SpawnCheatCloud(string name, Vector3 cursor, float delta)
     {
         stage.Clouds.AddCloud(SimulationParameters.Instance.GetCompound(name),
-            8000.0f * delta, stage.Camera.CursorWorldPos);
+            8000.0f * delta, cursor);
+    }
+
+    private void StopRecording()
+    {
+        if (recording == null)
+            return;
+
+        try
+        {
+            recording.Save(CommandLineOptions.RecordInputPath);
+            GD.Print("Input recording of ", recording.Frames.Count, " frames written to: ",
+                CommandLineOptions.RecordInputPath);
+        }
+        catch (System.IO.IOException e)
+        {
+            GD.PrintErr("Failed to save the input recording: ", e.Message);
+        }
+
+        recording = null;
+        SimulationRandom.SetWorldSeed(null);
+    }
+
+    private void StartReplay(string path)
+    {
+        try
+        {
+            replay = InputRecording.Load(path);
+        }
+        catch (System.IO.IOException e)
+        {
+            GD.PrintErr("Failed to load the input recording: ", e.Message);
+            GetTree().Quit();
+            return;
+        }
+
+        if (replay.GameVersion != Constants.Version)
+        {
+            GD.Print("Replaying a recording made with version ", replay.GameVersion,
+                ", the simulation may diverge from the recorded session");
+        }
+
+        SimulationRandom.SetWorldSeed(replay.Seed);
+
+        replayFrame = 0;
+        replayFrameTimes = new List<float>(replay.Frames.Count);
+        lastReplayFrameTicks = OS.GetTicksUsec();
+        AllocationTracker.Instance.Reset();
+
+        GD.Print("Replaying ", replay.Frames.Count, " frames of input with seed: ", replay.Seed);
+    }
+
+    /// <summary>
+    ///   Reads the next frame of the replay and adjusts the engine time scale so that the following frame gets the
+    ///   recorded delta.
+    /// </summary>
+    /// <returns>False when the replay has ended</returns>
+    private bool ReadReplayFrame(float delta, out InputRecording.Actions actions, out Vector2 cursor)
+    {
+        var now = OS.GetTicksUsec();
+        replayFrameTimes.Add((now - lastReplayFrameTicks) / 1000.0f);
+        lastReplayFrameTicks = now;
+
+        if (replayFrame >= replay.Frames.Count)
+        {
+            actions = InputRecording.Actions.None;
+            cursor = Vector2.Zero;
+
+            EndReplay();
+            GetTree().Quit();
+            return false;
+        }
+
+        var frame = replay.Frames[replayFrame++];
+        actions = frame.Actions;
+        cursor = frame.Cursor;
+
+        // With the --fixed-fps option every frame has the same base step, which is scaled by the time scale. So
+        // this is exact when running with that.
+        if (replayFrame < replay.Frames.Count && delta > 0)
+        {
+            var baseStep = delta / Engine.TimeScale;
+            Engine.TimeScale = replay.Frames[replayFrame].Delta / baseStep;
+        }
+
+        return true;
+    }
+
+    private void EndReplay()
+    {
+        Engine.TimeScale = 1.0f;
+
+        var sorted = replayFrameTimes.OrderBy(time => time).ToList();
+        var allocations = AllocationTracker.Instance.Total;
+
+        var result = new ReplayResult
+        {
+            Recording = CommandLineOptions.ReplayInputPath,
+            GameVersion = Constants.Version,
+            RecordedGameVersion = replay.GameVersion,
+            Frames = replayFrame,
+            TotalSeconds = sorted.Sum() / 1000.0f,
+            AverageMilliseconds = sorted.Count > 0 ? sorted.Average() : 0,
+            Percentile95Milliseconds = sorted.Count > 0 ? sorted[(int)(sorted.Count * 0.95f)] : 0,
+            MaxMilliseconds = sorted.Count > 0 ? sorted[sorted.Count - 1] : 0,
+            AllocatedBytesPerFrame = replayFrame > 0 ? allocations.AllocatedBytes / replayFrame : 0,
+            Gen0Collections = allocations.Gen0Collections,
+            Gen1Collections = allocations.Gen1Collections,
+            Gen2Collections = allocations.Gen2Collections,
+            MaxPauseEstimateMilliseconds = AllocationTracker.Instance.MaxPauseEstimate,
+        };
+
+        GD.Print("Replay finished, ", result.Frames, " frames took ", result.TotalSeconds, " s");
+
+        FileHelpers.MakeSureDirectoryExists(Constants.BENCHMARK_FOLDER);
+        var path = PathUtils.Join(Constants.BENCHMARK_FOLDER, "replay.json");
+
+        using (var file = new File())
+        {
+            if (file.Open(path, File.ModeFlags.Write) == Error.Ok)
+            {
+                file.StoreString(JsonConvert.SerializeObject(result, Formatting.Indented));
+                file.Close();
+            }
+            else
+            {
+                GD.PrintErr("Can't write replay results to: ", path);
+            }
+        }
+
+        replay = null;
+        SimulationRandom.SetWorldSeed(null);
+    }
+
+    private class ReplayResult
+    {
+        public string Recording { get; set; }
+        public string GameVersion { get; set; }
+        public string RecordedGameVersion { get; set; }
+        public int Frames { get; set; }
+        public float TotalSeconds { get; set; }
+        public float AverageMilliseconds { get; set; }
+        public float Percentile95Milliseconds { get; set; }
+        public float MaxMilliseconds { get; set; }
+        public long AllocatedBytesPerFrame { get; set; }
+        public int Gen0Collections { get; set; }
+        public int Gen1Collections { get; set; }
+        public int Gen2Collections { get; set; }
+        public float MaxPauseEstimateMilliseconds { get; set; }
     }
 }
@@ -0,0 +1,357 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using Newtonsoft.Json;
+
+/// <summary>
+///   Populations of each species in each patch over the recent generations, for graphs and analytics
+/// </summary>
+/// <remarks>
+///   <para>
+///     The history is stored by columns: each species and patch pair has its own array of populations, indexed by
+///     generation through a ring buffer shared by all the columns. So looking up one value is a dictionary lookup
+///     and an array access. Only the last Constants.POPULATION_HISTORY_GENERATIONS generations are kept, columns
+///     that are 0 for all of those are dropped.
+///   </para>
+///   <para>
+///     In saves the columns are stored as the differences between consecutive generations, written as zigzag
+///     varints. Populations change slowly compared to their size so most values take only a few bytes.
+///   </para>
+/// </remarks>
+public class PopulationHistory
+{
+    /// <summary>
+    ///   Increased when the encoding changes
+    /// </summary>
+    private const int ENCODING_VERSION = 1;
+
+    private readonly Dictionary<SeriesKey, Column> columns = new Dictionary<SeriesKey, Column>();
+
+    private int capacity = Constants.POPULATION_HISTORY_GENERATIONS;
+
+    /// <summary>
+    ///   World time of each stored generation, uses the same slots as the columns
+    /// </summary>
+    private double[] times;
+
+    /// <summary>
+    ///   The slot the oldest stored generation is in
+    /// </summary>
+    private int startSlot;
+
+    public PopulationHistory()
+    {
+        times = new double[capacity];
+    }
+
+    /// <summary>
+    ///   Number of generations stored
+    /// </summary>
+    [JsonIgnore]
+    public int Count { get; private set; }
+
+    /// <summary>
+    ///   Number of generations ever recorded, the generation numbers start from 0
+    /// </summary>
+    [JsonIgnore]
+    public int TotalRecorded { get; private set; }
+
+    [JsonIgnore]
+    public int FirstGeneration => TotalRecorded - Count;
+
+    [JsonIgnore]
+    public int LatestGeneration => TotalRecorded - 1;
+
+    [JsonIgnore]
+    public int ColumnCount => columns.Count;
+
+    [JsonIgnore]
+    public long Bytes => columns.Count * (long)capacity * sizeof(long) + times.LongLength * sizeof(double);
+
+    /// <summary>
+    ///   The encoded history, this is what is saved
+    /// </summary>
+    [JsonProperty]
+    private byte[] Data
+    {
+        get => Encode();
+        set => Decode(value);
+    }
+
+    /// <summary>
+    ///   Records the current populations of a map as the next generation
+    /// </summary>
+    /// <param name="map">Map to read the populations from</param>
+    /// <param name="time">World time of the generation</param>
+    /// <returns>The number of the recorded generation</returns>
+    public int Record(PatchMap map, double time)
+    {
+        int slot = (startSlot + Count) % capacity;
+
+        if (Count == capacity)
+        {
+            // The oldest generation is overwritten
+            startSlot = (startSlot + 1) % capacity;
+        }
+        else
+        {
+            ++Count;
+        }
+
+        int generation = TotalRecorded++;
+        times[slot] = time;
+
+        foreach (var column in columns.Values)
+            column.Values[slot] = 0;
+
+        foreach (var patch in map.Patches.Values)
+        {
+            foreach (var entry in patch.SpeciesInPatch)
+            {
+                if (entry.Value == 0)
+                    continue;
+
+                var key = new SeriesKey(entry.Key.ID, patch.ID);
+
+                if (!columns.TryGetValue(key, out var column))
+                {
+                    column = new Column(capacity);
+                    columns[key] = column;
+                }
+
+                column.Values[slot] = entry.Value;
+                column.LastNonZeroGeneration = generation;
+            }
+        }
+
+        RemoveEmptyColumns();
+
+        return generation;
+    }
+
+    public bool HasGeneration(int generation)
+    {
+        return generation >= FirstGeneration && generation <= LatestGeneration;
+    }
+
+    /// <summary>
+    ///   Returns the population of a species in a patch at a stored generation, 0 if it wasn't in the patch
+    /// </summary>
+    /// <exception cref="ArgumentOutOfRangeException">If the generation isn't stored</exception>
+    public long GetPopulation(uint speciesId, int patchId, int generation)
+    {
+        int slot = GetSlot(generation);
+
+        if (!columns.TryGetValue(new SeriesKey(speciesId, patchId), out var column))
+            return 0;
+
+        return column.Values[slot];
+    }
+
+    public double GetTime(int generation)
+    {
+        return times[GetSlot(generation)];
+    }
+
+    /// <summary>
+    ///   Returns the IDs of the species that have some population in the stored generations
+    /// </summary>
+    public IEnumerable<uint> GetTrackedSpecies()
+    {
+        return columns.Keys.Select(key => key.Species).Distinct();
+    }
+
+    public void Clear()
+    {
+        columns.Clear();
+        Count = 0;
+        TotalRecorded = 0;
+        startSlot = 0;
+    }
+
+    private static void WriteVarint(BinaryWriter writer, ulong value)
+    {
+        while (value >= 0x80)
+        {
+            writer.Write((byte)(value | 0x80));
+            value >>= 7;
+        }
+
+        writer.Write((byte)value);
+    }
+
+    private static void WriteSignedVarint(BinaryWriter writer, long value)
+    {
+        // Zigzag so that small negative values are small too
+        WriteVarint(writer, (ulong)((value << 1) ^ (value >> 63)));
+    }
+
+    private static ulong ReadVarint(BinaryReader reader)
+    {
+        ulong result = 0;
+        int shift = 0;
+
+        while (true)
+        {
+            byte current = reader.ReadByte();
+            result |= (ulong)(current & 0x7f) << shift;
+
+            if ((current & 0x80) == 0)
+                return result;
+
+            shift += 7;
+
+            if (shift > 63)
+                throw new InvalidDataException("Too long varint in population history");
+        }
+    }
+
+    private static long ReadSignedVarint(BinaryReader reader)
+    {
+        ulong value = ReadVarint(reader);
+        return (long)(value >> 1) ^ -(long)(value & 1);
+    }
+
+    private int GetSlot(int generation)
+    {
+        if (!HasGeneration(generation))
+            throw new ArgumentOutOfRangeException(nameof(generation), "Generation is not in the population history");
+
+        return (startSlot + generation - FirstGeneration) % capacity;
+    }
+
+    private void RemoveEmptyColumns()
+    {
+        var empty = columns.Where(entry => entry.Value.LastNonZeroGeneration < FirstGeneration)
+            .Select(entry => entry.Key).ToList();
+
+        foreach (var key in empty)
+            columns.Remove(key);
+    }
+
+    private byte[] Encode()
+    {
+        using (var stream = new MemoryStream())
+        using (var writer = new BinaryWriter(stream))
+        {
+            WriteVarint(writer, ENCODING_VERSION);
+            WriteVarint(writer, (ulong)capacity);
+            WriteVarint(writer, (ulong)TotalRecorded);
+            WriteVarint(writer, (ulong)Count);
+
+            for (int i = 0; i < Count; ++i)
+                writer.Write(times[(startSlot + i) % capacity]);
+
+            WriteVarint(writer, (ulong)columns.Count);
+
+            foreach (var entry in columns)
+            {
+                WriteVarint(writer, entry.Key.Species);
+                WriteSignedVarint(writer, entry.Key.Patch);
+
+                long previous = 0;
+
+                for (int i = 0; i < Count; ++i)
+                {
+                    long value = entry.Value.Values[(startSlot + i) % capacity];
+                    WriteSignedVarint(writer, value - previous);
+                    previous = value;
+                }
+            }
+
+            writer.Flush();
+            return stream.ToArray();
+        }
+    }
+
+    private void Decode(byte[] data)
+    {
+        Clear();
+
+        if (data == null || data.Length < 1)
+            return;
+
+        using (var reader = new BinaryReader(new MemoryStream(data)))
+        {
+            if (ReadVarint(reader) != ENCODING_VERSION)
+                throw new InvalidDataException("Unknown population history encoding version");
+
+            // The saved capacity is used to not lose any generations if the constant has changed
+            capacity = (int)ReadVarint(reader);
+            TotalRecorded = (int)ReadVarint(reader);
+            Count = (int)ReadVarint(reader);
+
+            if (Count > capacity || Count > TotalRecorded)
+                throw new InvalidDataException("Invalid population history generation count");
+
+            times = new double[capacity];
+
+            for (int i = 0; i < Count; ++i)
+                times[i] = reader.ReadDouble();
+
+            int columnCount = (int)ReadVarint(reader);
+
+            for (int i = 0; i < columnCount; ++i)
+            {
+                var key = new SeriesKey((uint)ReadVarint(reader), (int)ReadSignedVarint(reader));
+                var column = new Column(capacity);
+
+                long value = 0;
+
+                for (int generation = 0; generation < Count; ++generation)
+                {
+                    value += ReadSignedVarint(reader);
+                    column.Values[generation] = value;
+
+                    if (value != 0)
+                        column.LastNonZeroGeneration = FirstGeneration + generation;
+                }
+
+                columns[key] = column;
+            }
+        }
+    }
+
+    private struct SeriesKey : IEquatable<SeriesKey>
+    {
+        public readonly uint Species;
+        public readonly int Patch;
+
+        public SeriesKey(uint species, int patch)
+        {
+            Species = species;
+            Patch = patch;
+        }
+
+        public bool Equals(SeriesKey other)
+        {
+            return Species == other.Species && Patch == other.Patch;
+        }
+
+        public override bool Equals(object obj)
+        {
+            return obj is SeriesKey other && Equals(other);
+        }
+
+        public override int GetHashCode()
+        {
+            return (int)Species * 397 ^ Patch;
+        }
+    }
+
+    private class Column
+    {
+        public readonly long[] Values;
+
+        public Column(int capacity)
+        {
+            Values = new long[capacity];
+        }
+
+        /// <summary>
+        ///   The column can be dropped once this generation is no longer stored
+        /// </summary>
+        public int LastNonZeroGeneration { get; set; } = -1;
+    }
+}
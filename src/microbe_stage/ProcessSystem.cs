@@ -1,4 +1,5 @@
 ﻿using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Threading.Tasks;
 using Godot;
@@ -10,6 +11,7 @@ public class ProcessSystem
 {
     private static readonly Compound ATP = SimulationParameters.Instance.GetCompound("atp");
     private readonly List<Task> tasks = new List<Task>();
+    private readonly Stopwatch stopwatch = new Stopwatch();
 
     private readonly Node worldRoot;
     private BiomeConditions biome;
@@ -129,22 +131,32 @@ public class ProcessSystem
             return;
         }
 
+        stopwatch.Restart();
+        var allocationStart = AllocationTracker.Instance.BeginMeasure();
+
         var nodes = worldRoot.GetTree().GetNodesInGroup(Constants.PROCESS_GROUP);
 
         // The objects are processed here in order to take advantage of threading
         var executor = TaskExecutor.Instance;
 
-        for (int i = 0; i < nodes.Count; i += Constants.PROCESS_OBJECTS_PER_TASK)
+        var tuner = QualityGovernor.Instance.ProcessTasks;
+        int objectsPerTask = tuner.BeginRun(nodes.Count);
+
+        for (int i = 0; i < nodes.Count; i += objectsPerTask)
         {
             int start = i;
 
             var task = new Task(() =>
             {
-                for (int a = start;
-                    a < start + Constants.PROCESS_OBJECTS_PER_TASK && a < nodes.Count; ++a)
+                var taskStart = tuner.TaskStarted();
+                int a;
+
+                for (a = start; a < start + objectsPerTask && a < nodes.Count; ++a)
                 {
                     ProcessNode(nodes[a] as IProcessable, delta);
                 }
+
+                tuner.TaskFinished(taskStart, a - start);
             });
 
             tasks.Add(task);
@@ -153,6 +165,11 @@ public class ProcessSystem
         // Start and wait for tasks to finish
         executor.RunTasks(tasks);
         tasks.Clear();
+        tuner.EndRun();
+
+        QualityGovernor.Instance.ReportSystemTime(QualityGovernor.GovernedSystem.Processes,
+            (float)stopwatch.Elapsed.TotalMilliseconds);
+        AllocationTracker.Instance.EndMeasure(QualityGovernor.GovernedSystem.Processes, allocationStart);
     }
 
     /// <summary>
@@ -249,6 +266,21 @@ public class ProcessSystem
             return;
         }
 
+        // Entities away from the player run their processes less often, for the time since the last run
+        if (processor is ISimulationTiered tiered)
+        {
+            float backlog = processor.ProcessBacklog + delta;
+
+            if (backlog < SimulationTierSystem.GetProcessInterval(tiered.SimulationTier))
+            {
+                processor.ProcessBacklog = backlog;
+                return;
+            }
+
+            processor.ProcessBacklog = 0;
+            delta = backlog;
+        }
+
         var bag = processor.ProcessCompoundStorage;
 
         // Set all compounds to not be useful, when some compound is
@@ -0,0 +1,20 @@
+/// <summary>
+///   How much detail an entity is simulated with, see SimulationTierSystem
+/// </summary>
+public enum SimulationTier
+{
+    /// <summary>
+    ///   Full rate updates and visual effects
+    /// </summary>
+    Near,
+
+    /// <summary>
+    ///   Processes run at a lower rate and there are no visual effects
+    /// </summary>
+    Mid,
+
+    /// <summary>
+    ///   Updated in batches at a low rate, the AI thinks less often and the physics may sleep
+    /// </summary>
+    Far,
+}
@@ -0,0 +1,118 @@
+using Godot;
+
+/// <summary>
+///   Sorts the spawned entities into simulation tiers by their distance to the player
+/// </summary>
+/// <remarks>
+///   <para>
+///     Near entities are simulated fully. Mid range entities run their processes at a lower rate with the time
+///     since the previous run, and skip visual effects like flashing and the membrane wiggle. Far entities are
+///     also updated in batches, their AI thinks less often and they don't get pushed by the fluid currents so
+///     that their physics can sleep. The simulated time is the same in all tiers so the compound and population
+///     outcomes stay about the same.
+///   </para>
+/// </remarks>
+public class SimulationTierSystem
+{
+    private readonly Node worldRoot;
+
+    private float elapsed;
+
+    public SimulationTierSystem(Node worldRoot)
+    {
+        this.worldRoot = worldRoot;
+    }
+
+    public int NearCount { get; private set; }
+
+    public int MidCount { get; private set; }
+
+    public int FarCount { get; private set; }
+
+    /// <summary>
+    ///   Returns the interval a tier runs processes at, 0 for every frame
+    /// </summary>
+    public static float GetProcessInterval(SimulationTier tier)
+    {
+        switch (tier)
+        {
+            case SimulationTier.Mid:
+                return Constants.SIMULATION_TIER_MID_PROCESS_INTERVAL;
+            case SimulationTier.Far:
+                return Constants.SIMULATION_TIER_FAR_UPDATE_INTERVAL;
+            default:
+                return 0;
+        }
+    }
+
+    /// <summary>
+    ///   Used by the far entities to update in batches. Adds delta to the backlog and tells whether it is time to
+    ///   update.
+    /// </summary>
+    /// <param name="backlog">Time not yet updated for, reset when the update should happen</param>
+    /// <param name="delta">Frame time, replaced with the time to update for</param>
+    /// <returns>True if the update should happen now</returns>
+    public static bool TakeFarUpdateTime(ref float backlog, ref float delta)
+    {
+        backlog += delta;
+
+        if (backlog < Constants.SIMULATION_TIER_FAR_UPDATE_INTERVAL)
+            return false;
+
+        delta = backlog;
+        backlog = 0;
+        return true;
+    }
+
+    /// <summary>
+    ///   Start value for the update backlog of an entity that became far, so that the far entities don't all
+    ///   update on the same frame
+    /// </summary>
+    public static float GetStaggeredBacklog(Node entity)
+    {
+        return entity.GetInstanceId() % 16 / 16.0f * Constants.SIMULATION_TIER_FAR_UPDATE_INTERVAL;
+    }
+
+    public void Process(float delta, Vector3 playerPosition)
+    {
+        elapsed += delta;
+
+        if (elapsed < Constants.SIMULATION_TIER_UPDATE_INTERVAL)
+            return;
+
+        elapsed = 0;
+
+        int near = 0;
+        int mid = 0;
+        int far = 0;
+
+        foreach (Node entity in worldRoot.GetTree().GetNodesInGroup(Constants.SPAWNED_GROUP))
+        {
+            if (!(entity is ISimulationTiered tiered) || !(entity is Spatial spatial))
+                continue;
+
+            float distanceSquared = spatial.Translation.DistanceSquaredTo(playerPosition);
+
+            if (distanceSquared < Constants.SIMULATION_TIER_NEAR_DISTANCE * Constants.SIMULATION_TIER_NEAR_DISTANCE)
+            {
+                tiered.SimulationTier = SimulationTier.Near;
+                ++near;
+            }
+            else if (distanceSquared <
+                Constants.SIMULATION_TIER_FAR_DISTANCE * Constants.SIMULATION_TIER_FAR_DISTANCE)
+            {
+                tiered.SimulationTier = SimulationTier.Mid;
+                ++mid;
+            }
+            else
+            {
+                tiered.SimulationTier = SimulationTier.Far;
+                ++far;
+            }
+        }
+
+        NearCount = near;
+        MidCount = mid;
+        FarCount = far;
+    }
+}
@@ -25,7 +25,7 @@ public class SpawnSystem
     private List<Spawner> spawnTypes = new List<Spawner>();
 
     [JsonProperty]
-    private Random random = new Random();
+    private Random random = SimulationRandom.Create();
 
     /// <summary>
     ///   Delete a max of this many entities per step to reduce lag
@@ -73,6 +73,20 @@ public class SpawnSystem
         worldRoot = root;
     }
 
+    /// <summary>
+    ///   Estimate of the existing spawned entities
+    /// </summary>
+    [JsonIgnore]
+    public int EntityEstimate => estimateEntityCount;
+
+    [JsonIgnore]
+    public int EntityLimit => CurrentEntityLimit;
+
+    /// <summary>
+    ///   The entity limit lowered by the quality governor
+    /// </summary>
+    private int CurrentEntityLimit => QualityGovernor.Instance.LimitAliveEntities(maxAliveEntities);
+
     /// <summary>
     ///   Adds an externally spawned entity to be despawned
     /// </summary>
@@ -143,6 +157,25 @@ public class SpawnSystem
         }
     }
 
+    /// <summary>
+    ///   Counts the spawned microbes by species ID
+    /// </summary>
+    public Dictionary<uint, int> CountSpawnedMicrobes()
+    {
+        var result = new Dictionary<uint, int>();
+
+        foreach (Node entity in worldRoot.GetTree().GetNodesInGroup(Constants.SPAWNED_GROUP))
+        {
+            if (!(entity is Microbe microbe) || microbe.Dead)
+                continue;
+
+            result.TryGetValue(microbe.Species.ID, out int count);
+            result[microbe.Species.ID] = count + 1;
+        }
+
+        return result;
+    }
+
     /// <summary>
     ///   Processes spawning and despawning things
     /// </summary>
@@ -176,6 +209,9 @@ public class SpawnSystem
 
             spawnTypes.RemoveAll(entity => entity.DestroyQueued);
 
+            foreach (var spawnType in spawnTypes)
+                spawnType.PausedFor -= interval;
+
             SpawnEntities(playerPosition, playerRotation, estimateEntityCount, spawnsLeftThisFrame);
         }
     }
@@ -188,7 +224,7 @@ public class SpawnSystem
     private int HandleQueuedSpawns(int spawnsLeftThisFrame)
     {
         // If we don't have room, just abandon spawning
-        if (estimateEntityCount >= maxAliveEntities)
+        if (estimateEntityCount >= CurrentEntityLimit)
         {
             queuedSpawns.Spawns.Dispose();
             queuedSpawns = null;
@@ -196,7 +232,7 @@ public class SpawnSystem
         }
 
         // Spawn from the queue
-        while (estimateEntityCount < maxAliveEntities && spawnsLeftThisFrame > 0)
+        while (estimateEntityCount < CurrentEntityLimit && spawnsLeftThisFrame > 0)
         {
             if (!queuedSpawns.Spawns.MoveNext())
             {
@@ -219,13 +255,16 @@ public class SpawnSystem
     private void SpawnEntities(Vector3 playerPosition, Vector3 playerRotation, int existing, int spawnsLeftThisFrame)
     {
         // If  there are already too many entities, don't spawn more
-        if (existing >= maxAliveEntities)
+        if (existing >= CurrentEntityLimit)
             return;
 
         int spawned = 0;
 
         foreach (var spawnType in spawnTypes)
         {
+            if (spawnType.PausedFor > 0)
+                continue;
+
             /*
             To actually spawn a given entity for a given attempt, two
             conditions should be met. The first condition is a random
@@ -244,9 +283,14 @@ public class SpawnSystem
             int numAttempts = Math.Min(Math.Max(spawnType.SpawnFrequency * 2, 1),
                 maxTriesPerSpawner);
 
+            // Spawners bringing back the entities of a restored patch try once for each of them
+            if (spawnType.RestoredEntitiesLeft > numAttempts)
+                numAttempts = Math.Min(spawnType.RestoredEntitiesLeft, maxTriesPerSpawner);
+
             for (int i = 0; i < numAttempts; i++)
             {
-                if (random.Next(0, numAttempts + 1) < spawnType.SpawnFrequency)
+                if (spawnType.RestoredEntitiesLeft > 0 ||
+                    random.Next(0, numAttempts + 1) < spawnType.SpawnFrequency)
                 {
                     /*
                     First condition passed. Choose a location for the entity.
@@ -311,7 +355,7 @@ public class SpawnSystem
             // TODO: this is a bit awkward if this
             // stops compound clouds from spawning as
             // well...
-            if (spawned + existing >= maxAliveEntities)
+            if (spawned + existing >= CurrentEntityLimit)
             {
                 // We likely couldn't spawn things next frame anyway if we are at the entity limit,
                 // so the spawner is not stored here
@@ -381,6 +425,9 @@ public class SpawnSystem
         entity.DespawnRadiusSqr = spawnType.SpawnRadiusSqr;
 
         entity.SpawnedNode.AddToGroup(Constants.SPAWNED_GROUP);
+
+        if (spawnType.RestoredEntitiesLeft > 0)
+            --spawnType.RestoredEntitiesLeft;
     }
 
     /// <summary>
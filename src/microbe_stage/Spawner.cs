@@ -29,6 +29,17 @@ public abstract class Spawner
     /// <value>The spawn frequency.</value>
     public int SpawnFrequency { get; set; }
 
+    /// <summary>
+    ///   Seconds until this starts spawning, used to not spawn more clouds in a patch whose clouds were restored
+    /// </summary>
+    public float PausedFor { get; set; }
+
+    /// <summary>
+    ///   Entities to spawn back because they were around when the player left the patch. While this is above 0 the
+    ///   spawn attempts of this spawner skip the random chance.
+    /// </summary>
+    public int RestoredEntitiesLeft { get; set; }
+
     /// <summary>
     ///   If this is queued to be destroyed the spawn system will remove this on next update
     /// </summary>
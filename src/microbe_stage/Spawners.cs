@@ -55,6 +55,7 @@ public static class SpawnHelpers
 
         microbe.AddToGroup(Constants.AI_TAG_MICROBE);
         microbe.AddToGroup(Constants.PROCESS_GROUP);
+        microbe.AddToGroup(Constants.PLANAR_PHYSICS_GROUP);
 
         if (aiControlled)
             microbe.AddToGroup(Constants.AI_GROUP);
@@ -207,6 +208,7 @@ public static class SpawnHelpers
 
         chunk.AddToGroup(Constants.FLUID_EFFECT_GROUP);
         chunk.AddToGroup(Constants.AI_TAG_CHUNK);
+        chunk.AddToGroup(Constants.PLANAR_PHYSICS_GROUP);
         return chunk;
     }
 
@@ -218,14 +220,8 @@ public static class SpawnHelpers
     public static void SpawnCloud(CompoundCloudSystem clouds, Vector3 location,
         Compound compound, float amount)
     {
-        int resolution = Settings.Instance.CloudResolution;
-
         // This spreads out the cloud spawn a bit
-        clouds.AddCloud(compound, amount, location + new Vector3(0 + resolution, 0, 0));
-        clouds.AddCloud(compound, amount, location + new Vector3(0 - resolution, 0, 0));
-        clouds.AddCloud(compound, amount, location + new Vector3(0, 0, 0 + resolution));
-        clouds.AddCloud(compound, amount, location + new Vector3(0, 0, 0 - resolution));
-        clouds.AddCloud(compound, amount, location + new Vector3(0, 0, 0));
+        clouds.AddCloudStamp(compound, amount, location, CloudStamp.Spawn);
     }
 
     /// <summary>
@@ -233,7 +229,7 @@ public static class SpawnHelpers
     /// </summary>
     public static AgentProjectile SpawnAgent(AgentProperties properties, float amount,
         float lifetime, Vector3 location, Vector3 direction,
-        Node worldRoot, PackedScene agentScene, Node emitter)
+        Node worldRoot, PackedScene agentScene, Node emitter, Random random)
     {
         var normalizedDirection = direction.Normalized();
 
@@ -246,13 +242,14 @@ public static class SpawnHelpers
         worldRoot.AddChild(agent);
         agent.Translation = location + (direction * 1.5f);
 
-        // TODO: pass in this random from somewhere
-        agent.Rotate(new Vector3(0, 1, 0), 2 * Mathf.Pi * (float)new Random().NextDouble());
+        agent.Rotate(new Vector3(0, 1, 0), 2 * Mathf.Pi * (float)random.NextDouble());
 
-        agent.ApplyCentralImpulse(normalizedDirection *
-            Constants.AGENT_EMISSION_IMPULSE_STRENGTH);
+        // The velocity is set instead of applying an impulse as an impulse only changes LinearVelocity after the
+        // next Godot physics step, and the planar physics takes the starting velocity of new bodies from it
+        agent.LinearVelocity = normalizedDirection * Constants.AGENT_EMISSION_IMPULSE_STRENGTH / agent.Mass;
 
         agent.AddToGroup(Constants.TIMED_GROUP);
+        agent.AddToGroup(Constants.PLANAR_PHYSICS_GROUP);
         return agent;
     }
 
@@ -318,7 +315,7 @@ public class MicrobeSpawner : Spawner
         this.cloudSystem = cloudSystem;
         this.currentGame = currentGame;
 
-        random = new Random();
+        random = SimulationRandom.Create();
     }
 
     public override IEnumerable<ISpawned> Spawn(Node worldNode, Vector3 location)
@@ -372,7 +369,7 @@ public class ChunkSpawner : Spawner
 {
     private readonly PackedScene chunkScene;
     private readonly ChunkConfiguration chunkType;
-    private readonly Random random = new Random();
+    private readonly Random random = SimulationRandom.Create();
     private readonly CompoundCloudSystem cloudSystem;
 
     public ChunkSpawner(ChunkConfiguration chunkType, CompoundCloudSystem cloudSystem)
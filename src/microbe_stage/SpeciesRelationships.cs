@@ -0,0 +1,151 @@
+using System.Collections.Generic;
+
+/// <summary>
+///   How the species present in the stage relate to each other, so that the AI doesn't need to work out for each
+///   pair of cells whether one is prey or a predator for the other
+/// </summary>
+/// <remarks>
+///   <para>
+///     This is rebuilt by MicrobeAISystem before the AI runs and must not be modified while the AI tasks are
+///     running. The sizes are calculated from the species organelles, so cells that have grown extra organelles
+///     for dividing are treated like the rest of their species.
+///   </para>
+/// </remarks>
+public class SpeciesRelationships
+{
+    private readonly Dictionary<Species, int> indices = new Dictionary<Species, int>();
+
+    private readonly List<Traits> traits = new List<Traits>();
+
+    /// <summary>
+    ///   Relationship of species a to species b is at a * count + b
+    /// </summary>
+    private Relationship[] matrix = new Relationship[0];
+
+    public int SpeciesCount => traits.Count;
+
+    /// <summary>
+    ///   Builds the relationships between the species of the given microbes
+    /// </summary>
+    public void Build(IEnumerable<Microbe> microbes)
+    {
+        indices.Clear();
+        traits.Clear();
+
+        foreach (var microbe in microbes)
+        {
+            var species = microbe.Species;
+
+            if (species == null || indices.ContainsKey(species))
+                continue;
+
+            indices[species] = traits.Count;
+            traits.Add(new Traits(species));
+        }
+
+        int count = traits.Count;
+
+        if (matrix.Length < count * count)
+            matrix = new Relationship[count * count];
+
+        for (int a = 0; a < count; ++a)
+        {
+            for (int b = 0; b < count; ++b)
+            {
+                matrix[a * count + b] = a == b ? default : new Relationship(traits[a], traits[b]);
+            }
+        }
+    }
+
+    /// <summary>
+    ///   How species self relates to species other. Unknown species have no relationship.
+    /// </summary>
+    public Relationship Get(Species self, Species other)
+    {
+        if (self == null || other == null || !indices.TryGetValue(self, out int a) ||
+            !indices.TryGetValue(other, out int b))
+        {
+            return default;
+        }
+
+        return matrix[a * traits.Count + b];
+    }
+
+    /// <summary>
+    ///   True if the species has agent vacuoles for shooting toxins
+    /// </summary>
+    public bool HasToxins(Species species)
+    {
+        return species != null && indices.TryGetValue(species, out int index) && traits[index].AgentVacuoles > 0;
+    }
+
+    public struct Relationship
+    {
+        /// <summary>
+        ///   True when the first species is aggressive and big enough to hunt the second
+        /// </summary>
+        public readonly bool IsPrey;
+
+        /// <summary>
+        ///   True when the first species is afraid of the second
+        /// </summary>
+        public readonly bool IsPredator;
+
+        /// <summary>
+        ///   How threatening the second species is to the first, scaled by the first species fear. Above 1 the
+        ///   second species is a predator.
+        /// </summary>
+        public readonly float ThreatLevel;
+
+        internal Relationship(Traits self, Traits other)
+        {
+            IsPrey = self.Aggression == Constants.MAX_SPECIES_AGRESSION ||
+                (self.AgentVacuoles + self.EngulfSize) * (self.Aggression / Constants.AGRESSION_DIVISOR) >
+                other.EngulfSize;
+
+            // Toxins give the courage to stand up to bigger cells
+            float threat = (self.AgentVacuoles + other.EngulfSize) * (self.Fear / Constants.FEAR_DIVISOR);
+
+            ThreatLevel = self.EngulfSize > 0 ? threat / self.EngulfSize : float.MaxValue;
+
+            IsPredator = self.Fear == Constants.MAX_SPECIES_FEAR || threat > self.EngulfSize;
+        }
+    }
+
+    /// <summary>
+    ///   The species properties the relationships are calculated from
+    /// </summary>
+    internal struct Traits
+    {
+        public readonly float EngulfSize;
+        public readonly int AgentVacuoles;
+        public readonly float Aggression;
+        public readonly float Fear;
+
+        public Traits(Species species)
+        {
+            int hexes = 0;
+            AgentVacuoles = 0;
+
+            if (species is MicrobeSpecies microbeSpecies && microbeSpecies.Organelles != null)
+            {
+                foreach (var organelle in microbeSpecies.Organelles.Organelles)
+                {
+                    hexes += organelle.Definition.HexCount;
+
+                    if (organelle.Definition.HasComponentFactory<AgentVacuoleComponentFactory>())
+                        ++AgentVacuoles;
+                }
+
+                EngulfSize = microbeSpecies.IsBacteria ? hexes * 0.5f : hexes;
+            }
+            else
+            {
+                EngulfSize = 0;
+            }
+
+            Aggression = species.Aggression;
+            Fear = species.Fear;
+        }
+    }
+}
@@ -7,7 +7,7 @@ using Newtonsoft.Json;
 /// <summary>
 ///   Main class of the microbe editor
 /// </summary>
-public class MicrobeEditor : Node, ILoadableGameState
+public class MicrobeEditor : Node, ILoadableGameState, IMemoryReporter
 {
     [Export]
     public NodePath PauseMenuPath;
@@ -22,6 +22,8 @@ public class MicrobeEditor : Node, ILoadableGameState
     /// </summary>
     public float CurrentOrganelleCost;
 
+    private readonly FirstFramesTimer firstFramesTimer = new FirstFramesTimer("Microbe editor");
+
     private MicrobeSymmetry symmetry = MicrobeSymmetry.None;
 
     private MicrobeCamera camera;
@@ -269,6 +271,12 @@ public class MicrobeEditor : Node, ILoadableGameState
     /// </summary>
     public bool NeedToRestoreStageFromSave { get; set; }
 
+    /// <summary>
+    ///   True once the auto-evo results have been applied and editing can be finished
+    /// </summary>
+    [JsonIgnore]
+    public bool EditorReady => ready;
+
     [JsonIgnore]
     public bool HasNucleus
     {
@@ -504,6 +512,8 @@ public class MicrobeEditor : Node, ILoadableGameState
         editedSpecies.Colour = Colour;
         editedSpecies.MembraneRigidity = Rigidity;
 
+        editedSpecies.UpdateGenome();
+
         // Move patches
         if (targetPatch != null)
         {
@@ -596,6 +606,7 @@ public class MicrobeEditor : Node, ILoadableGameState
             OnEditorReady();
         }
 
+        firstFramesTimer.Frame(delta);
         UpdateEditor(delta);
     }
 
@@ -950,6 +961,19 @@ public class MicrobeEditor : Node, ILoadableGameState
         CalculateOrganelleEffectivenessInPatch(targetPatch);
     }
 
+    public void ReportMemory(MemoryReport report)
+    {
+        report.Add("Editor", "actions", 0, history?.ActionCount ?? 0);
+        report.Add("Editor", "hex nodes", 0, placedHexes?.Count ?? 0);
+        report.Add("Editor", "organelle models", 0, placedModels?.Count ?? 0);
+
+        // The stage is kept around while editing
+        ReturnToStage?.ReportMemory(report);
+
+        if (ReturnToStage == null)
+            CurrentGame?.GameWorld.ReportMemory(report);
+    }
+
     /// <summary>
     ///   Changes the number of mutation points left. Should only be called by EditorAction
     /// </summary>
@@ -1781,19 +1805,14 @@ public class MicrobeEditor : Node, ILoadableGameState
     private void ApplyAutoEvoResults()
     {
         GD.Print("Applying auto-evo results");
-        CurrentGame.GameWorld.GetAutoEvoRun().ApplyExternalEffects();
 
-        var extinct = CurrentGame.GameWorld.Map.RemoveExtinctSpecies(FreeBuilding);
+        var extinct = CurrentGame.GameWorld.ApplyAutoEvoResults(CurrentGame.GameWorld.GetAutoEvoRun(), FreeBuilding);
 
         foreach (var species in extinct)
         {
-            CurrentGame.GameWorld.RemoveSpecies(species);
-
             GD.Print("Species ", species.FormattedName, " has gone extinct from the world.");
         }
 
-        CurrentGame.GameWorld.Map.UpdateGlobalPopulations();
-
         // Clear the run to make the cell stage start a new run when we go back there
         CurrentGame.GameWorld.ResetAutoEvoRun();
     }
@@ -146,6 +146,7 @@ public class InProgressLoad
             {
                 stopwatch.Stop();
                 GD.Print("load finished, success: ", success, " message: ", message, " elapsed: ", stopwatch.Elapsed);
+                MetricsExporter.Instance?.ReportLoadDuration(stopwatch.Elapsed);
 
                 // Stop suppressing loaded node deletion
                 TemporaryLoadedNodeDeleter.Instance.RemoveDeletionHold(Constants.DELETION_HOLD_LOAD);
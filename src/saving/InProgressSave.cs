@@ -178,6 +178,7 @@ public class InProgressSave : IDisposable
             {
                 stopwatch.Stop();
                 GD.Print("save finished, success: ", success, " message: ", message, " elapsed: ", stopwatch.Elapsed);
+                MetricsExporter.Instance?.ReportSaveDuration(stopwatch.Elapsed);
 
                 if (success)
                 {